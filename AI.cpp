@@ -1,18 +1,20 @@
 #include "AI.h"
 #include "Board.h"
 #include "Piece.h"
+#include "MovePicker.h"
 #include <ctime>
 #include <cstdlib>
 #include <iostream>
 #include <algorithm>
 #include <string>
 #include <vector>
+#include <chrono>
 // #include <queue>
 
 
 MoveList::MoveList() : head(nullptr), tail(nullptr) {}
 
-void MoveList::addMove(const pair<pair<int, int>, pair<int, int>> &move)
+void MoveList::addMove(Move move)
 {
     MoveNode *newNode = new MoveNode(move);
     if (head == nullptr)
@@ -27,9 +29,9 @@ void MoveList::addMove(const pair<pair<int, int>, pair<int, int>> &move)
 }
 
 
-vector<pair<pair<int, int>, pair<int, int>>> MoveList ::getAllMoves()
+vector<Move> MoveList ::getAllMoves()
 {
-    vector<pair<pair<int, int>, pair<int, int>>> moves;
+    vector<Move> moves;
     MoveNode *current = head;
     while (current != nullptr)
     {
@@ -49,7 +51,7 @@ MoveList::~MoveList()
         current = nextNode;
     }
 }
-MoveNode::MoveNode(const pair<pair<int, int>, pair<int, int>> move) : move(move), next(nullptr) {}
+MoveNode::MoveNode(Move move) : move(move), next(nullptr) {}
 
 CircularQueue::CircularQueue(int size) : size(size) {}
 
@@ -58,38 +60,30 @@ bool CircularQueue::isEmpty() const
     return q.empty(); // Return true if the queue is empty
 }
 
-bool CircularQueue::isMoveRecent(pair<pair<int, int>, pair<int, int>> move)
+bool CircularQueue::isMoveRecent(Move move)
 {
-    // Convert both parts of the move pair into strings
-    string moveStr = to_string(move.first.first) + "," + to_string(move.first.second) + " -> " +
-                     to_string(move.second.first) + "," + to_string(move.second.second);
-    
     // Check if the move exists in the seenMoves set
-    return seenMoves.find(moveStr) != seenMoves.end();
+    return seenMoves.find(move.raw()) != seenMoves.end();
 }
 
-void CircularQueue::addMove(pair<std::pair<int, int>, std::pair<int, int>> move)
+void CircularQueue::addMove(Move move)
 {
     if (q.size() == size)
     {
         // Remove the oldest move from the queue and `seenMoves` if the queue is full
-        string oldMoveStr = to_string(q.front().first.first) + "," + std::to_string(q.front().first.second) +
-                            " -> " + std::to_string(q.front().second.first) + "," + std::to_string(q.front().second.second);
-        seenMoves.erase(oldMoveStr);
+        seenMoves.erase(q.front().raw());
         q.pop();
     }
 
     // Add the new move to the queue
     q.push(move);
-
-    // Insert the string representation of the new move into seenMoves
-    string moveStr = to_string(move.first.first) + "," + to_string(move.first.second) +
-                     " -> " + to_string(move.second.first) + "," + to_string(move.second.second);
-    seenMoves.insert(moveStr);
+    seenMoves.insert(move.raw());
 }
 
 
-AI::AI(int moveHistorySize) : moveHistory(moveHistorySize) {}
+AI::AI(int moveHistorySize, size_t hashSizeMb)
+    : moveHistory(moveHistorySize), engineMode(HEURISTIC_ENGINE), searchLimits(4, 0),
+      transpositionTable(hashSizeMb), search(transpositionTable), lastStats{0, 0} {}
 
 void MoveList ::clear_moves()
 {
@@ -101,9 +95,9 @@ void MoveList ::clear_moves()
     }
     tail = nullptr; // Reset tail as well
 }
-pair<pair<int, int>, pair<int, int>> AI::getRandomMove(MoveList &moveList)
+Move AI::getRandomMove(MoveList &moveList)
 {
-    vector<pair<pair<int, int>, pair<int, int>>> moves = moveList.getAllMoves();
+    vector<Move> moves = moveList.getAllMoves();
 
     if (moves.empty())
     {
@@ -133,52 +127,35 @@ void AI::exploreMovesBFS(pair<int, int> startMove, const Board &board)
         auto currentMove = q.front();
         q.pop();
         cout << "Exploring move: (" << currentMove.first << ", " << currentMove.second << ")\n";
-        shared_ptr<Piece> currentPiece = board.getPiece(currentMove.first, currentMove.second); // Get pointer to the piece
+        PieceCode currentPiece = board.pieceAt(toSquare(currentMove.first, currentMove.second));
 
         // Check if the current position has a piece
-        if (!currentPiece)
+        if (currentPiece == NO_PIECE)
         {
             cout << "No piece at the starting position (" << currentMove.first << ", " << currentMove.second << "). Skipping...\n";
             continue; // Skip this iteration if there is no piece at the starting position
         }
 
         // Get all legal moves from currentMove
-        vector<pair<int, int>> legalMoveList = currentPiece->getLegalMoves(currentMove.first, currentMove.second, board);
+        vector<pair<int, int>> legalMoveList = pieceMoveList(currentPiece, currentMove.first, currentMove.second, board);
 
         // Add legal moves to queue if not recently made
         for (const auto &move : legalMoveList)
         {
-            // Create a pair of pairs for the move
-            pair<pair<int, int>, pair<int, int>> movePair = {{currentMove.first, currentMove.second}, move};
+            Move packedMove = Move::fromCoordinates(currentMove.first, currentMove.second, move.first, move.second);
 
             // Avoid repeating moves recently made
-            if (!recentMoves.isMoveRecent(movePair)) 
+            if (!recentMoves.isMoveRecent(packedMove))
             {
-                possibleMoves.addMove(movePair); // Add the move pair
+                possibleMoves.addMove(packedMove);
                 q.push(move); // Add the move to the queue
-                recentMoves.addMove(movePair); // Use movePair here instead of move
+                recentMoves.addMove(packedMove);
             }
         }
     }
 }
 
 
-void AI::sortMovesByPriority(vector<pair<pair<int, int>, pair<int, int>>> &moves, const Board &board)
-{
-    // Example: prioritize capturing moves or moves with higher impact
-    std::sort(moves.begin(), moves.end(), [&](const pair<pair<int, int>, pair<int, int>> &a, const pair<pair<int, int>, pair<int, int>> &b)
-              {
-                  // Placeholder logic: prioritize based on target position or capturing
-                  shared_ptr<Piece> pieceA = board.getPiece(a.second.first, a.second.second);
-                  shared_ptr<Piece> pieceB = board.getPiece(b.second.first, b.second.second);
-
-                  int priorityA = (pieceA != nullptr) ? 1 : 0; // Higher priority for capturing
-                  int priorityB = (pieceB != nullptr) ? 1 : 0;
-
-                  return priorityA > priorityB; // Sort descending by priority
-              });
-}
-
 bool MoveList::isEmpty()
 {
     return head == nullptr; // Return true if the head is null, indicating the list is empty
@@ -188,25 +165,12 @@ void AI::generatePossibleMoves(const Board &board)
 {
     possibleMoves.clear_moves(); // Ensure it's cleared before adding new moves.
 
-    for (int x = 0; x < 8; ++x)
+    // The AI plays black and is only asked on its own turn. The picker hands out the
+    // legal moves best first (captures by MVV-LVA, then quiets), so the list is ordered.
+    MovePicker picker(board, MOVE_NONE);
+    for (Move move = picker.next(); move != MOVE_NONE; move = picker.next())
     {
-        for (int y = 0; y < 8; ++y)
-        {
-            shared_ptr<Piece> piece = board.getPiece(x, y);
-            if (piece != nullptr && piece->getColor() == false)
-            { // Assuming AI plays black
-                // Generate legal moves for this piece
-                vector<pair<int, int>> legalMoves = piece->getLegalMoves(x, y, board);
-                for (const auto &move : legalMoves)
-                {
-                    // Validate move to ensure it doesn’t leave the board or violate rules
-                    if (piece->isValidMove(x, y, move.first, move.second))
-                    {
-                        possibleMoves.addMove({{x, y}, move});
-                    }
-                }
-            }
-        }
+        possibleMoves.addMove(move);
     }
 
     if (possibleMoves.isEmpty())
@@ -237,17 +201,44 @@ void AI::generatePossibleMoves(const Board &board)
 //     }
 
 
-pair<pair<int, int>, pair<int, int>> AI::selectMove(const Board &board)
+Move AI::selectMove(Board &board)
+{
+    if (engineMode == ALPHA_BETA_ENGINE)
+    {
+        return selectSearchMove(board);
+    }
+
+    auto startTime = chrono::steady_clock::now();
+    auto move = selectHeuristicMove(board);
+    lastStats.nodes = possibleMoves.getAllMoves().size();
+    lastStats.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+    return move;
+}
+
+Move AI::selectSearchMove(Board &board)
+{
+    lastSearch = search.run(board, searchLimits);
+    lastStats.nodes = lastSearch.nodes;
+    lastStats.elapsedMs = lastSearch.elapsedMs;
+
+    if (!lastSearch.hasMove)
+    {
+        return MOVE_NONE; // Handle case where AI has no valid moves
+    }
+    return lastSearch.bestMove;
+}
+
+Move AI::selectHeuristicMove(const Board &board)
 {
     // Step 1: Generate possible moves
     generatePossibleMoves(board);
 
     // Step 2: Retrieve all possible moves
-    vector<pair<pair<int, int>, pair<int, int>>> moves = possibleMoves.getAllMoves();
+    vector<Move> moves = possibleMoves.getAllMoves();
     if (moves.empty())
     {
         // cout << "No moves available for AI. Returning default." << endl;
-        return {{-1, -1}, {-1, -1}}; // Handle case where AI has no valid moves
+        return MOVE_NONE; // Handle case where AI has no valid moves
     }
 
     // cout << "Possible moves:\n";
@@ -257,20 +248,13 @@ pair<pair<int, int>, pair<int, int>> AI::selectMove(const Board &board)
     //          << " -> " << move.second.first << "," << move.second.second << endl;
     // }
 
-    // Step 3: Sort moves by priority (optional optimization)
-    sortMovesByPriority(moves, board);
-    // cout << "Moves sorted by priority (if applicable):\n";
-    // for (const auto &move : moves)
-    // {
-    //     cout << "Sorted Move: " << move.first.first << "," << move.first.second
-    //          << " -> " << move.second.first << "," << move.second.second << endl;
-    // }
+    // Step 3: The moves already come best first (see generatePossibleMoves)
 
     // Step 4: If this is the first move, pick the highest-priority move
     if (moveHistory.isEmpty())
     {
         auto firstMove = moves.front();
-        moveHistory.addMove(firstMove); // Assuming `addMove` expects pair<pair<int, int>, pair<int, int>>
+        moveHistory.addMove(firstMove);
         // cout << "First move selected: " << firstMove.first.first << "," << firstMove.first.second
         //      << " -> " << firstMove.second.first << "," << firstMove.second.second << endl;
         return firstMove;
@@ -283,9 +267,9 @@ pair<pair<int, int>, pair<int, int>> AI::selectMove(const Board &board)
         // cout << "Checking move: " << move.first.first << "," << move.first.second
         //      << " -> " << move.second.first << "," << move.second.second << endl;
         
-        if (!moveHistory.isMoveRecent(move)) // Assuming `isMoveRecent` expects pair<pair<int, int>, pair<int, int>>
+        if (!moveHistory.isMoveRecent(move))
         {
-            moveHistory.addMove(move); // Assuming `addMove` expects pair<pair<int, int>, pair<int, int>>
+            moveHistory.addMove(move);
             // cout << "Move selected: " << move.first.first << "," << move.first.second
             //      << " -> " << move.second.first << "," << move.second.second << endl;
             return move;
@@ -300,7 +284,7 @@ pair<pair<int, int>, pair<int, int>> AI::selectMove(const Board &board)
     // Step 6: No non-recent moves found, pick a random valid move
     // cout << "No non-recent moves found. Picking a random valid move...\n";
     auto randomMove = getRandomMove(possibleMoves);
-    moveHistory.addMove(randomMove); // Assuming `addMove` expects pair<pair<int, int>, pair<int, int>>
+    moveHistory.addMove(randomMove);
     // cout << "Random move selected: " << randomMove.first.first << "," << randomMove.first.second
     //      << " -> " << randomMove.second.first << "," << randomMove.second.second << endl;
     return randomMove;
@@ -308,36 +292,32 @@ pair<pair<int, int>, pair<int, int>> AI::selectMove(const Board &board)
 
 bool AI::isMoveValid(const Move &move, Board &board)
 {
-    // Initialize Checkmate with the board's current state
-    Checkmate checkmate(board.getBoard()); // Pass board reference to Checkmate
-
-    cout << "Checking move validity: " << move.startX << "," << move.startY << " -> " << move.endX << "," << move.endY << endl;
+    cout << "Checking move validity: " << move.startX() << "," << move.startY() << " -> " << move.endX() << "," << move.endY() << endl;
 
-    // Check if the move is within board bounds
-    if (move.startX < 0 || move.startX >= 8 || move.startY < 0 || move.startY >= 8 ||
-        move.endX < 0 || move.endX >= 8 || move.endY < 0 || move.endY >= 8)
+    // A packed move always holds on-board squares; MOVE_NONE is the only one to reject
+    if (move == MOVE_NONE)
     {
         cout << "Move is out of bounds!" << endl;
         return false;
     }
 
     // Get the piece at the starting position
-    shared_ptr<Piece> piece = board.getPiece(move.startX, move.startY);
-    if (piece == nullptr)
+    PieceCode piece = board.pieceAt(move.from());
+    if (piece == NO_PIECE)
     {
         cout << "No piece at the start position!" << endl;
         return false; // No piece at the starting position
     }
 
     // Ensure that the AI's piece is being moved
-    if (piece->getColor() != false)
+    if (pieceColor(piece) != BLACK)
     {
         cout << "Not an AI piece!" << endl;
         return false; // Not an AI piece
     }
 
     // Check if the move is valid for the piece using the movePiece function (without actually making the move)
-    if (!board.movePiece(move.startX, move.startY, move.endX, move.endY))
+    if (!board.movePiece(move.startX(), move.startY(), move.endX(), move.endY()))
     {
         cout << "Invalid move based on the board logic!" << endl;
         return false; // Invalid move based on the logic defined in movePiece
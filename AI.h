@@ -10,6 +10,8 @@
 #include "Piece.h" // Include the Piece
 #include "Stack.h"
 #include "Queue.h"
+#include "Search.h"
+#include "ParallelSearch.h"
 
 using namespace std;
 
@@ -22,22 +24,22 @@ class CircularQueue
 {
 public:
     int size;
-    Queue<pair<pair<int, int>, pair<int, int>>> q;  // Change q to hold the correct type
-    unordered_set<string> seenMoves;
+    Queue<Move> q;
+    unordered_set<uint16_t> seenMoves; // Packed moves, see Move::raw()
 
     CircularQueue(int size);
-    bool isMoveRecent(pair<pair<int, int>, pair<int, int>> move);
-    void addMove(pair<pair<int, int>, pair<int, int>> move);
+    bool isMoveRecent(Move move);
+    void addMove(Move move);
     bool isEmpty() const;
 };
 
 class MoveNode
 {
 public:
-    pair<pair<int, int>, pair<int, int>> move; // Start and end positions
-    MoveNode *next;                            // Pointer to the next MoveNode
+    Move move;      // Start and end squares, with the move's flag
+    MoveNode *next; // Pointer to the next MoveNode
 
-    MoveNode(const pair<pair<int, int>, pair<int, int>> move);
+    MoveNode(Move move);
 };
 
 class MoveList
@@ -46,8 +48,8 @@ public:
     MoveList();  // Constructor to initialize the head of the list
     ~MoveList();
 
-    void addMove(const pair<pair<int, int>, pair<int, int>> &move);                                    // Add a move to the list
-    vector<pair<pair<int, int>, pair<int, int>>> getAllMoves(); // Get all moves in a vector
+    void addMove(Move move);     // Add a move to the list
+    vector<Move> getAllMoves();  // Get all moves in a vector
     void clear_moves();
     bool isEmpty();
 
@@ -85,6 +87,22 @@ private:
 //     }
 // };
 
+// How the AI picks its move
+enum AIEngineMode
+{
+    HEURISTIC_ENGINE,  // Captures first, avoiding recently played moves (no lookahead)
+    ALPHA_BETA_ENGINE  // Iterative-deepening alpha-beta search
+};
+
+// Cost of the last move decision, so both engines can be compared
+struct AIStats
+{
+    uint64_t nodes;   // Moves considered (heuristic) or positions searched (alpha-beta)
+    double elapsedMs;
+
+    double nodesPerSecond() const { return elapsedMs > 0 ? nodes * 1000.0 / elapsedMs : 0; }
+};
+
 // AI Class to manage the AI's decision-making
 class AI
 {
@@ -92,14 +110,36 @@ private:
     CircularQueue moveHistory;
     MoveList possibleMoves;
     // GameTreeNode* gameTreeRoot; // The root of the game tree
+    AIEngineMode engineMode;
+    SearchLimits searchLimits;
+    TranspositionTable transpositionTable; // Kept between moves, so earlier searches still help
+    ParallelSearch search;
+    SearchResult lastSearch; // Result of the last alpha-beta search
+    AIStats lastStats;
 
 public:
-   AI(int moveHistorySize);
+   // hashSizeMb: size of the alpha-beta engine's transposition table
+   AI(int moveHistorySize, size_t hashSizeMb = 16);
+
+    void setEngineMode(AIEngineMode mode) { engineMode = mode; }
+    AIEngineMode getEngineMode() const { return engineMode; }
+    // Limits for the alpha-beta engine, by depth, by time in milliseconds, or both
+    void setSearchLimits(const SearchLimits &limits) { searchLimits = limits; }
+    const SearchResult &getLastSearchResult() const { return lastSearch; }
+    const AIStats &getLastStats() const { return lastStats; }
+    // Search threads for the alpha-beta engine (Lazy SMP), including the calling thread
+    void setThreadCount(int threads) { search.setThreadCount(threads); }
+    int getThreadCount() const { return search.getThreadCount(); }
+    // Transposition table counters for the last alpha-beta search
+    TTStats getHashStats() const { return lastSearch.hashStats; }
 
     void generatePossibleMoves(const Board &board);
-    pair<pair<int, int>, pair<int, int>> selectMove(const Board &board);
-    void sortMovesByPriority(vector<pair<pair<int, int>, pair<int, int>>> &moves, const Board &board);
-    pair<pair<int, int>, pair<int, int>> getRandomMove(MoveList &moveList);
+    // Picks a move with the current engine, MOVE_NONE if there is none.
+    // The board is searched in place and left unchanged.
+    Move selectMove(Board &board);
+    Move selectHeuristicMove(const Board &board);
+    Move selectSearchMove(Board &board);
+    Move getRandomMove(MoveList &moveList);
     void exploreMovesBFS(pair<int, int> startMove, const Board &board);
     bool isMoveValid(const Move &move, Board &board);
     // void buildGameTree(const Board& board, int depth, GameTreeNode* currentNode);
@@ -0,0 +1,70 @@
+#include "Bitboard.h"
+
+namespace
+{
+    // Row/column step for each RayDirection
+    constexpr int RAY_DX[RAY_COUNT] = {-1, 1, 0, 0, -1, -1, 1, 1};
+    constexpr int RAY_DY[RAY_COUNT] = {0, 0, 1, -1, 1, -1, 1, -1};
+
+    constexpr bool onBoard(int x, int y)
+    {
+        return x >= 0 && x < 8 && y >= 0 && y < 8;
+    }
+
+    // Squares reached from (x, y) by each of the given single steps
+    constexpr Bitboard stepAttacks(int x, int y, const int (&dx)[8], const int (&dy)[8])
+    {
+        Bitboard attacks = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            if (onBoard(x + dx[i], y + dy[i]))
+            {
+                attacks |= squareBB(toSquare(x + dx[i], y + dy[i]));
+            }
+        }
+        return attacks;
+    }
+
+    constexpr AttackTables buildAttackTables()
+    {
+        constexpr int KNIGHT_DX[8] = {2, 2, -2, -2, 1, 1, -1, -1};
+        constexpr int KNIGHT_DY[8] = {1, -1, 1, -1, 2, -2, 2, -2};
+        constexpr int KING_DX[8] = {-1, -1, -1, 0, 0, 1, 1, 1};
+        constexpr int KING_DY[8] = {-1, 0, 1, -1, 1, -1, 0, 1};
+
+        AttackTables t{};
+        for (int sq = 0; sq < 64; ++sq)
+        {
+            int x = squareRow(sq), y = squareCol(sq);
+            t.knight[sq] = stepAttacks(x, y, KNIGHT_DX, KNIGHT_DY);
+            t.king[sq] = stepAttacks(x, y, KING_DX, KING_DY);
+
+            // White pawns capture towards row 0, black pawns towards row 7
+            for (int dy = -1; dy <= 1; dy += 2)
+            {
+                if (onBoard(x - 1, y + dy))
+                    t.pawn[WHITE][sq] |= squareBB(toSquare(x - 1, y + dy));
+                if (onBoard(x + 1, y + dy))
+                    t.pawn[BLACK][sq] |= squareBB(toSquare(x + 1, y + dy));
+            }
+
+            for (int dir = 0; dir < RAY_COUNT; ++dir)
+            {
+                Bitboard ray = 0;
+                for (int nx = x + RAY_DX[dir], ny = y + RAY_DY[dir]; onBoard(nx, ny); nx += RAY_DX[dir], ny += RAY_DY[dir])
+                {
+                    int target = toSquare(nx, ny);
+                    ray |= squareBB(target);
+                    // Everything already on the ray lies between sq and target
+                    t.between[sq][target] = ray & ~squareBB(target);
+                }
+                t.ray[dir][sq] = ray;
+                t.queenRays[sq] |= ray;
+            }
+        }
+        return t;
+    }
+}
+
+extern const AttackTables ATTACK_TABLES;
+constexpr AttackTables ATTACK_TABLES = buildAttackTables();
@@ -0,0 +1,289 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+// The PEXT slider backend needs a 64-bit x86 CPU (and is only used if it has BMI2)
+#if defined(__x86_64__) || defined(_M_X64)
+#define SLIDER_PEXT_AVAILABLE 1
+#else
+#define SLIDER_PEXT_AVAILABLE 0
+#endif
+
+// A Bitboard is a set of squares packed into 64 bits.
+// Square index = x * 8 + y, using the same (row, column) coordinates as Board:
+// row 0 is rank 8 (black's back rank) and column 0 is file 'a'.
+// So a8 = 0, h8 = 7, a1 = 56 and h1 = 63.
+typedef uint64_t Bitboard;
+
+enum Color
+{
+    WHITE = 0,
+    BLACK = 1
+};
+
+enum PieceType
+{
+    PAWN = 0,
+    KNIGHT,
+    BISHOP,
+    ROOK,
+    QUEEN,
+    KING,
+    NO_PIECE_TYPE
+};
+
+// A piece as one byte: PieceType in the low 3 bits, Color in bit 3.
+// An empty square holds NO_PIECE, whose type bits read as NO_PIECE_TYPE.
+enum PieceCode : uint8_t
+{
+    W_PAWN = 0,
+    W_KNIGHT,
+    W_BISHOP,
+    W_ROOK,
+    W_QUEEN,
+    W_KING,
+    NO_PIECE,
+    B_PAWN = 8,
+    B_KNIGHT,
+    B_BISHOP,
+    B_ROOK,
+    B_QUEEN,
+    B_KING,
+    PIECE_CODE_NB = 16
+};
+
+// Castling rights, one bit per side and wing
+enum CastlingRight
+{
+    WHITE_KINGSIDE = 1,
+    WHITE_QUEENSIDE = 2,
+    BLACK_KINGSIDE = 4,
+    BLACK_QUEENSIDE = 8,
+    ALL_CASTLING = 15
+};
+
+const int NO_SQUARE = -1;
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard ROW_0_BB = 0xFFULL; // Rank 8
+constexpr Bitboard ROW_7_BB = ROW_0_BB << 56; // Rank 1
+constexpr Bitboard LIGHT_SQUARES_BB = 0xAA55AA55AA55AA55ULL; // a8, h1 and every square of their color
+
+inline Color opposite(Color c) { return Color(c ^ 1); }
+inline Color colorOf(bool isWhite) { return isWhite ? WHITE : BLACK; }
+
+constexpr PieceCode makePiece(Color c, PieceType type) { return PieceCode(type | c << 3); }
+constexpr PieceType typeOf(PieceCode piece) { return PieceType(piece & 7); }
+constexpr Color pieceColor(PieceCode piece) { return Color(piece >> 3); } // Not meaningful for NO_PIECE
+// Board letter (uppercase for white), indexed by PieceCode
+constexpr char PIECE_CODE_SYMBOLS[PIECE_CODE_NB + 1] = "PNBRQK. pnbrqk..";
+constexpr char pieceSymbol(PieceCode piece) { return PIECE_CODE_SYMBOLS[piece]; }
+
+constexpr int toSquare(int x, int y) { return x * 8 + y; }
+constexpr int squareRow(int sq) { return sq >> 3; }
+constexpr int squareCol(int sq) { return sq & 7; }
+constexpr Bitboard squareBB(int sq) { return 1ULL << sq; }
+constexpr Bitboard rowBB(int x) { return ROW_0_BB << (8 * x); }
+constexpr Bitboard colBB(int y) { return FILE_A_BB << y; }
+
+inline int popCount(Bitboard b)
+{
+#if defined(_MSC_VER)
+    return (int)__popcnt64(b);
+#else
+    return __builtin_popcountll(b);
+#endif
+}
+
+// Index of the least significant set bit (b must not be empty)
+inline int lsb(Bitboard b)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, b);
+    return (int)idx;
+#else
+    return __builtin_ctzll(b);
+#endif
+}
+
+// Index of the most significant set bit (b must not be empty)
+inline int msb(Bitboard b)
+{
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanReverse64(&idx, b);
+    return (int)idx;
+#else
+    return 63 ^ __builtin_clzll(b);
+#endif
+}
+
+// Removes the least significant square from b and returns it
+inline int popLsb(Bitboard &b)
+{
+    int sq = lsb(b);
+    b &= b - 1;
+    return sq;
+}
+
+// Shifts towards row 0 (white's forward direction) and towards row 7
+constexpr Bitboard shiftUp(Bitboard b) { return b >> 8; }
+constexpr Bitboard shiftDown(Bitboard b) { return b << 8; }
+// One step towards the promotion row of color C (white moves towards row 0)
+template <Color C>
+constexpr Bitboard pawnPush(Bitboard b) { return C == WHITE ? shiftUp(b) : shiftDown(b); }
+
+// Ray directions used by the sliding pieces
+enum RayDirection
+{
+    RAY_UP = 0,     // Towards row 0
+    RAY_DOWN,       // Towards row 7
+    RAY_RIGHT,      // Towards column 7
+    RAY_LEFT,       // Towards column 0
+    RAY_UP_RIGHT,
+    RAY_UP_LEFT,
+    RAY_DOWN_RIGHT,
+    RAY_DOWN_LEFT,
+    RAY_COUNT
+};
+
+// Pre-computed attack tables. They are built by constexpr code in Bitboard.cpp,
+// so there is no start-up cost.
+struct AttackTables
+{
+    Bitboard knight[64];
+    Bitboard king[64];
+    Bitboard pawn[2][64];
+    Bitboard ray[RAY_COUNT][64];
+    Bitboard queenRays[64]; // All eight rays: every square sharing a line with sq
+    Bitboard between[64][64];
+};
+
+extern const AttackTables ATTACK_TABLES;
+
+inline Bitboard knightAttacks(int sq) { return ATTACK_TABLES.knight[sq]; }
+inline Bitboard kingAttacks(int sq) { return ATTACK_TABLES.king[sq]; }
+inline Bitboard pawnAttacks(Color c, int sq) { return ATTACK_TABLES.pawn[c][sq]; }
+// Squares attacked by a whole set of pawns of color c at once
+template <Color C>
+constexpr Bitboard pawnAttacksBB(Bitboard pawns)
+{
+    return C == WHITE ? ((pawns & ~FILE_A_BB) >> 9) | ((pawns & ~FILE_H_BB) >> 7)
+                      : ((pawns & ~FILE_A_BB) << 7) | ((pawns & ~FILE_H_BB) << 9);
+}
+inline Bitboard pawnAttacksBB(Color c, Bitboard pawns)
+{
+    return c == WHITE ? pawnAttacksBB<WHITE>(pawns) : pawnAttacksBB<BLACK>(pawns);
+}
+
+// Squares a queen on sq reaches on an empty board
+inline Bitboard queenRays(int sq) { return ATTACK_TABLES.queenRays[sq]; }
+
+// Squares strictly between a and b if they share a row, column or diagonal, otherwise empty
+inline Bitboard betweenBB(int a, int b) { return ATTACK_TABLES.between[a][b]; }
+
+// Magic bitboards: the blockers on a slider's relevant squares, multiplied by the
+// square's magic number and shifted, index a table of pre-computed attacks.
+// The tables are built at compile time in Magic.cpp.
+struct SliderMagic
+{
+    Bitboard mask;            // Squares whose occupancy changes the attacks
+    Bitboard magic;
+    const Bitboard *attacks;  // This square's table, 2^(64 - shift) entries
+    unsigned shift;           // 64 minus the number of mask bits
+
+    Bitboard lookup(Bitboard occupied) const { return attacks[((occupied & mask) * magic) >> shift]; }
+};
+
+struct MagicTables
+{
+    SliderMagic rook[64];
+    SliderMagic bishop[64];
+};
+
+extern const MagicTables MAGIC_TABLES;
+
+// Parallel bit extract: packs the bits of b selected by mask into the low bits
+inline Bitboard pext(Bitboard b, Bitboard mask)
+{
+#if SLIDER_PEXT_AVAILABLE && defined(_MSC_VER)
+    return _pext_u64(b, mask);
+#elif SLIDER_PEXT_AVAILABLE
+    // Inline assembly instead of the intrinsic, which would need the whole build to
+    // target BMI2. Only reached once the CPU check has passed.
+    Bitboard result;
+    __asm__("pextq %2, %1, %0" : "=r"(result) : "r"(b), "r"(mask));
+    return result;
+#else
+    Bitboard result = 0;
+    for (Bitboard bit = 1; mask; mask &= mask - 1, bit <<= 1)
+        if (b & mask & (0 - mask))
+            result |= bit;
+    return result;
+#endif
+}
+
+// PEXT tables: the blockers on the relevant squares, packed with pext(), directly
+// index the square's attack table. No multiply, no wasted slots, but only fast on
+// CPUs that run PEXT in hardware. Built at compile time in Pext.cpp.
+struct SliderPext
+{
+    Bitboard mask;
+    const Bitboard *attacks; // 2^popCount(mask) entries
+
+    Bitboard lookup(Bitboard occupied) const { return attacks[pext(occupied, mask)]; }
+};
+
+struct PextTables
+{
+    SliderPext rook[64];
+    SliderPext bishop[64];
+};
+
+extern const PextTables PEXT_TABLES;
+
+// Where rookAttacks()/bishopAttacks() look up their results. Both give identical attacks.
+enum SliderBackend
+{
+    MAGIC_BACKEND,
+    PEXT_BACKEND
+};
+
+// Picked once at startup from CPUID: PEXT when the CPU has fast BMI2, magics otherwise
+extern SliderBackend sliderBackend;
+
+bool cpuHasFastPext();
+// For benchmarks and tests; returns false (and changes nothing) if the CPU cannot run it
+bool setSliderBackend(SliderBackend backend);
+const char *sliderBackendName(SliderBackend backend);
+
+// Sliding piece attacks for the given occupancy
+inline Bitboard rookAttacks(int sq, Bitboard occupied)
+{
+#if SLIDER_PEXT_AVAILABLE
+    if (sliderBackend == PEXT_BACKEND)
+        return PEXT_TABLES.rook[sq].lookup(occupied);
+#endif
+    return MAGIC_TABLES.rook[sq].lookup(occupied);
+}
+inline Bitboard bishopAttacks(int sq, Bitboard occupied)
+{
+#if SLIDER_PEXT_AVAILABLE
+    if (sliderBackend == PEXT_BACKEND)
+        return PEXT_TABLES.bishop[sq].lookup(occupied);
+#endif
+    return MAGIC_TABLES.bishop[sq].lookup(occupied);
+}
+inline Bitboard queenAttacks(int sq, Bitboard occupied)
+{
+    return rookAttacks(sq, occupied) | bishopAttacks(sq, occupied);
+}
+
+#endif // BITBOARD_H
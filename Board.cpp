@@ -5,6 +5,9 @@
 #include <unordered_map>
 #include <cstdlib>
 #include <algorithm>
+#include <sstream>
+#include <cstring>
+#include <cctype>
 #include "Piece.h"
 #include "Checkmate.h"
 #include "Stack.h"
@@ -17,89 +20,313 @@ const string BLACK_BG = "\033[40m";
 const string WHITE_TEXT = "\033[97m";
 const string BLACK_TEXT = "\033[30m";
 
-LastMove lastMove; // Definition (with initialization)
-Stack<vector<vector<shared_ptr<Piece>>>> redoHistory;
+// Names used by the captured piece list, indexed by PieceType
+const char *const PIECE_NAMES[6] = {"Pawn", "Knight", "Bishop", "Rook", "Queen", "King"};
+
+// The piece codes are the board; getPiece() hands out one shared Piece object per
+// code so the Piece interface keeps working without a heap object per square.
+static shared_ptr<Piece> pieceFacade(PieceCode piece)
+{
+    static const shared_ptr<Piece> facades[PIECE_CODE_NB] = {
+        make_shared<Pawn>(true), make_shared<Knight>(true), make_shared<Bishop>(true),
+        make_shared<Rook>(true), make_shared<Queen>(true), make_shared<King>(true), nullptr, nullptr,
+        make_shared<Pawn>(false), make_shared<Knight>(false), make_shared<Bishop>(false),
+        make_shared<Rook>(false), make_shared<Queen>(false), make_shared<King>(false), nullptr, nullptr};
+    return facades[piece];
+}
 
 // Board.cpp
 Board::Board()
 {
-    // Resize the board to 8x8 and initialize with nullptr for pieces
-    board.resize(8, vector<shared_ptr<Piece>>(8, nullptr));
-
-    // Initialize the squareBoard (used for additional game-related information, e.g., state of each square)
-    squareBoard.resize(8, vector<Square>(8));
+    // Start from an empty board
+    clearBoard();
 
     // Setup the board with pieces
     setupBoard();
 
     // Initialize the last move (initially no move)
-    lastMove = {0, 0, 0, 0, false};
+    lastMove = {0, 0, 0, 0, false, NO_PIECE};
+}
 
-    // Initialize Checkmate with the current board state
-    checkmate = new Checkmate(board); // Pass the current board to Checkmate constructor
+void Board::clearBoard()
+{
+    for (Bitboard &bb : pos.typeBB)
+        bb = 0;
+    pos.colorBB[WHITE] = pos.colorBB[BLACK] = 0;
+    for (PieceCode &piece : pos.mailbox)
+        piece = NO_PIECE;
+    pos.kingSq[WHITE] = pos.kingSq[BLACK] = NO_SQUARE;
+    memset(pos.pieceCounts, 0, sizeof(pos.pieceCounts));
+    pos.castlingRights = 0;
+    pos.enPassantSquare = NO_SQUARE;
+    pos.sideToMove = WHITE;
+    pos.halfmoveClock = 0;
+    pos.fullmoveNumber = 1;
+    pos.hashKey = 0;
+    pos.attackedBB[WHITE] = pos.attackedBB[BLACK] = 0;
+}
 
-    // Clear redo history as no moves have been undone
-    while (!redoHistory.empty())
-    {
-        redoHistory.pop();
-    }
-    // Optional: Debugging output to print pieces on the board after setup
-    // Uncomment the following code if you want to debug
-    // for (int i = 0; i < 8; ++i) {
-    //     for (int j = 0; j < 8; ++j) {
-    //         if (board[i][j] != nullptr) {
-    //             cout << "Piece at (" << i << ", " << j << "): " << typeid(*board[i][j]).name() << endl;
-    //         }
-    //     }
-    // }
+void Board::putPiece(int sq, Color color, PieceType type)
+{
+    pos.typeBB[type] |= squareBB(sq);
+    pos.colorBB[color] |= squareBB(sq);
+    pos.mailbox[sq] = makePiece(color, type);
+    ++pos.pieceCounts[color][type];
+    if (type == KING)
+        pos.kingSq[color] = sq;
+    pos.hashKey ^= ZOBRIST.piece[color][type][sq];
 }
 
-// Board class method to get a reference to a square at (x, y)
-Square &Board::getSquare(int x, int y)
+// Drops the castling rights lost by moving from or to one of the king/rook squares
+void Board::updateCastlingRights(int from, int to)
 {
-    return squareBoard[x][y]; // Return the reference to Square object in squareBoard
+    Bitboard touched = squareBB(from) | squareBB(to);
+    if (touched & squareBB(toSquare(7, 4)))
+        pos.castlingRights &= ~(WHITE_KINGSIDE | WHITE_QUEENSIDE);
+    if (touched & squareBB(toSquare(0, 4)))
+        pos.castlingRights &= ~(BLACK_KINGSIDE | BLACK_QUEENSIDE);
+    if (touched & squareBB(toSquare(7, 7)))
+        pos.castlingRights &= ~WHITE_KINGSIDE;
+    if (touched & squareBB(toSquare(7, 0)))
+        pos.castlingRights &= ~WHITE_QUEENSIDE;
+    if (touched & squareBB(toSquare(0, 7)))
+        pos.castlingRights &= ~BLACK_KINGSIDE;
+    if (touched & squareBB(toSquare(0, 0)))
+        pos.castlingRights &= ~BLACK_QUEENSIDE;
 }
 
-void Board::setupBoard()
+// Attack map of one side, with the pawn direction fixed at compile time
+template <Color By>
+static Bitboard attacksOf(const Board &board)
+{
+    Bitboard occ = board.occupied();
+    Bitboard attacks = pawnAttacksBB<By>(board.pieces(By, PAWN));
+    for (Bitboard b = board.pieces(By, KNIGHT); b;)
+        attacks |= knightAttacks(popLsb(b));
+    for (Bitboard b = board.pieces(By, BISHOP) | board.pieces(By, QUEEN); b;)
+        attacks |= bishopAttacks(popLsb(b), occ);
+    for (Bitboard b = board.pieces(By, ROOK) | board.pieces(By, QUEEN); b;)
+        attacks |= rookAttacks(popLsb(b), occ);
+    for (Bitboard b = board.pieces(By, KING); b;)
+        attacks |= kingAttacks(popLsb(b));
+    return attacks;
+}
+
+Bitboard Board::computeAttacks(Color by) const
+{
+    return by == WHITE ? attacksOf<WHITE>(*this) : attacksOf<BLACK>(*this);
+}
+
+// Called whenever pieces change; unmakeMove() restores the maps from the undo record instead.
+// Both maps are rebuilt from scratch on purpose. Updating them incrementally needs an attack
+// set per square, updated for the moved pieces and every slider whose ray crosses from or to,
+// then merged back into the two maps; with no more than a dozen sliders on the board that
+// costs more than the full rebuild (see tools/perft.cpp and the movegen bench).
+void Board::updateAttackMaps()
 {
-    // Initialize an empty 8x8 board
-    board.resize(8, vector<shared_ptr<Piece>>(8, nullptr));
+    pos.attackedBB[WHITE] = attacksOf<WHITE>(*this);
+    pos.attackedBB[BLACK] = attacksOf<BLACK>(*this);
+}
+
+uint64_t Board::computeHashKey() const
+{
+    uint64_t key = ZOBRIST.castling[pos.castlingRights];
+    for (Bitboard occ = occupied(); occ;)
+    {
+        int sq = popLsb(occ);
+        key ^= ZOBRIST.piece[colorAt(sq)][pieceTypeAt(sq)][sq];
+    }
+    if (pos.enPassantSquare != NO_SQUARE)
+        key ^= ZOBRIST.enPassantFile[squareCol(pos.enPassantSquare)];
+    if (pos.sideToMove == BLACK)
+        key ^= ZOBRIST.blackToMove;
+    return key;
+}
 
-    // Initialize an empty 8x8 board for squares
-    squareBoard.resize(8, vector<Square>(8));
+void Board::setupBoard()
+{
+    // Start from an empty 8x8 board with no moves to undo
+    clearBoard();
+    clearHistory();
 
     // Set up Pawns
     for (int i = 0; i < 8; ++i)
     {
-        board[1][i] = make_shared<Pawn>(false); // Black pawns
-        board[6][i] = make_shared<Pawn>(true);  // White pawns
+        putPiece(toSquare(1, i), BLACK, PAWN); // Black pawns
+        putPiece(toSquare(6, i), WHITE, PAWN); // White pawns
+    }
+
+    // Back ranks, from column a to column h
+    const PieceType backRank[8] = {ROOK, KNIGHT, BISHOP, QUEEN, KING, BISHOP, KNIGHT, ROOK};
+    for (int i = 0; i < 8; ++i)
+    {
+        putPiece(toSquare(0, i), BLACK, backRank[i]);
+        putPiece(toSquare(7, i), WHITE, backRank[i]);
+    }
+
+    pos.castlingRights = ALL_CASTLING;
+    pos.hashKey ^= ZOBRIST.castling[pos.castlingRights];
+    updateAttackMaps();
+}
+
+bool Board::loadFEN(const string &fen)
+{
+    istringstream fields(fen);
+    string placement, side, castling, enPassant;
+    int halfmoves = 0, fullmoves = 1;
+    if (!(fields >> placement >> side))
+        return false;
+    if (!(fields >> castling))
+        castling = "-";
+    if (!(fields >> enPassant))
+        enPassant = "-";
+    if (!(fields >> halfmoves))
+        halfmoves = 0;
+    if (!(fields >> fullmoves) || fullmoves < 1)
+        fullmoves = 1;
+
+    // Piece placement, rank 8 (row 0) first
+    PieceCode squarePieces[64];
+    int row = 0, col = 0;
+    for (char c : placement)
+    {
+        if (c == '/')
+        {
+            if (col != 8)
+                return false;
+            ++row;
+            col = 0;
+        }
+        else if (c >= '1' && c <= '8')
+        {
+            for (int i = 0; i < c - '0'; ++i, ++col)
+            {
+                if (col >= 8)
+                    return false;
+                squarePieces[toSquare(row, col)] = NO_PIECE;
+            }
+        }
+        else
+        {
+            const char *symbol = static_cast<const char *>(memchr(PIECE_CODE_SYMBOLS, c, PIECE_CODE_NB));
+            if (!symbol || c == '.' || c == ' ' || row >= 8 || col >= 8)
+                return false;
+            squarePieces[toSquare(row, col)] = PieceCode(symbol - PIECE_CODE_SYMBOLS);
+            ++col;
+        }
+    }
+    if (row != 7 || col != 8 || (side != "w" && side != "b"))
+        return false;
+    // Exactly one king per side, so the cached king squares are always valid
+    if (count(squarePieces, squarePieces + 64, W_KING) != 1 || count(squarePieces, squarePieces + 64, B_KING) != 1)
+        return false;
+
+    int rights = 0;
+    if (castling != "-")
+    {
+        for (char c : castling)
+        {
+            const char *flags = "KQkq";
+            const char *found = strchr(flags, c);
+            if (!found)
+                return false;
+            rights |= 1 << (found - flags);
+        }
+    }
+
+    int epSquare = NO_SQUARE;
+    if (enPassant != "-")
+    {
+        if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' || enPassant[1] < '1' || enPassant[1] > '8')
+            return false;
+        epSquare = toSquare('8' - enPassant[1], enPassant[0] - 'a');
+    }
+
+    clearBoard();
+    clearHistory();
+    for (int sq = 0; sq < 64; ++sq)
+    {
+        if (squarePieces[sq] != NO_PIECE)
+            putPiece(sq, pieceColor(squarePieces[sq]), typeOf(squarePieces[sq]));
+    }
+    pos.sideToMove = side == "w" ? WHITE : BLACK;
+    pos.castlingRights = rights;
+    pos.halfmoveClock = halfmoves;
+    pos.fullmoveNumber = fullmoves;
+
+    // Like makeMove(), only keep an en-passant square that can actually be used
+    Color them = opposite(pos.sideToMove);
+    if (epSquare != NO_SQUARE && (pawnAttacks(them, epSquare) & pieces(pos.sideToMove, PAWN)))
+        pos.enPassantSquare = epSquare;
+    pos.hashKey = computeHashKey();
+    updateAttackMaps();
+    return true;
+}
+
+void Board::setPosition(const Position &position)
+{
+    pos = position;
+    clearHistory();
+}
+
+// A new position has nothing to undo or redo, and no last move for en passant
+void Board::clearHistory()
+{
+    while (!history.empty())
+    {
+        history.pop();
+    }
+    while (!redoHistory.empty())
+    {
+        redoHistory.pop();
     }
+    lastMove = {0, 0, 0, 0, false, NO_PIECE};
+}
 
-    // Set up Rooks
-    board[0][0] = make_shared<Rook>(false);
-    board[0][7] = make_shared<Rook>(false);
-    board[7][0] = make_shared<Rook>(true);
-    board[7][7] = make_shared<Rook>(true);
-
-    // Set up Knights
-    board[0][1] = make_shared<Knight>(false);
-    board[0][6] = make_shared<Knight>(false);
-    board[7][1] = make_shared<Knight>(true);
-    board[7][6] = make_shared<Knight>(true);
-
-    // Set up Bishops
-    board[0][2] = make_shared<Bishop>(false);
-    board[0][5] = make_shared<Bishop>(false);
-    board[7][2] = make_shared<Bishop>(true);
-    board[7][5] = make_shared<Bishop>(true);
-
-    // Set up Queens
-    board[0][3] = make_shared<Queen>(false);
-    board[7][3] = make_shared<Queen>(true);
-
-    // Set up Kings
-    board[0][4] = make_shared<King>(false);
-    board[7][4] = make_shared<King>(true);
+string Board::getFEN() const
+{
+    string fen;
+    for (int row = 0; row < 8; ++row)
+    {
+        int empty = 0;
+        for (int col = 0; col < 8; ++col)
+        {
+            PieceCode piece = pieceAt(toSquare(row, col));
+            if (piece == NO_PIECE)
+            {
+                ++empty;
+                continue;
+            }
+            if (empty)
+                fen += char('0' + empty);
+            empty = 0;
+            fen += pieceSymbol(piece);
+        }
+        if (empty)
+            fen += char('0' + empty);
+        if (row < 7)
+            fen += '/';
+    }
+
+    fen += pos.sideToMove == WHITE ? " w " : " b ";
+    if (pos.castlingRights == 0)
+        fen += '-';
+    for (int bit = 0; bit < 4; ++bit)
+    {
+        if (pos.castlingRights & (1 << bit))
+            fen += "KQkq"[bit];
+    }
+
+    fen += ' ';
+    if (pos.enPassantSquare == NO_SQUARE)
+        fen += '-';
+    else
+    {
+        fen += char('a' + squareCol(pos.enPassantSquare));
+        fen += char('8' - squareRow(pos.enPassantSquare));
+    }
+    fen += ' ' + to_string(pos.halfmoveClock) + ' ' + to_string(pos.fullmoveNumber);
+    return fen;
 }
 
 void Board::printBoard() const
@@ -115,10 +342,11 @@ void Board::printBoard() const
             string bgColor = isWhiteSquare ? WHITE_BG : BLACK_BG;
             string textColor = isWhiteSquare ? BLACK_TEXT : WHITE_TEXT;
 
-            if (board[i][j] != nullptr)
+            PieceCode piece = pieceAt(toSquare(i, j));
+            if (piece != NO_PIECE)
             {
                 // Display piece with symbol (alphabetic representation) and color
-                cout << bgColor << textColor << board[i][j]->getSymbol() << " " << RESET;
+                cout << bgColor << textColor << pieceSymbol(piece) << " " << RESET;
             }
             else
             {
@@ -133,41 +361,14 @@ void Board::printBoard() const
 
 bool Board::isSquareOccupied(int x, int y) const
 {
-    // cout << "Checking if square (" << x << ", " << y << ") is occupied..." << endl;
-    return board[x][y] != nullptr;
+    return (occupied() & squareBB(toSquare(x, y))) != 0;
 }
 
 bool Board::isPathClear(int startX, int startY, int endX, int endY) const
 {
-    // If the move is a knight move, no need to check for path blockage
-    int dx = abs(endX - startX);
-    int dy = abs(endY - startY);
-
-    // Knight moves in an L shape, so no need to check the path for knight
-    if ((dx == 2 && dy == 1) || (dx == 1 && dy == 2))
-    {
-        return true; // No path check for knight moves
-    }
-
-    // For other pieces, check if path is clear
-    dx = (endX - startX) == 0 ? 0 : (endX - startX) / abs(endX - startX);
-    dy = (endY - startY) == 0 ? 0 : (endY - startY) / abs(endY - startY);
-
-    int currentX = startX + dx;
-    int currentY = startY + dy;
-
-    // Traverse through all squares between start and end position
-    while (currentX != endX || currentY != endY)
-    {
-        if (isSquareOccupied(currentX, currentY))
-        {
-            return false; // Path is blocked
-        }
-        currentX += dx;
-        currentY += dy;
-    }
-
-    return true; // Path is clear
+    // Knight moves (and any other non-line move) have nothing in between,
+    // so betweenBB() is empty and the path is always clear
+    return (betweenBB(toSquare(startX, startY), toSquare(endX, endY)) & occupied()) == 0;
 }
 
 // void Board::buildAdjacencyList(vector<vector<int>> &adjList) const
@@ -299,40 +500,29 @@ bool Board::isPathClear(int startX, int startY, int endX, int endY) const
 // Function to get the white king's position
 pair<int, int> Board::getWhiteKingPosition()
 {
-    for (int i = 0; i < 8; ++i)
-    {
-        for (int j = 0; j < 8; ++j)
-        {
-            auto piece = board[i][j];
-            if (piece && piece->getSymbol() == 'K')
-            {
-                return {i, j};
-            }
-        }
-    }
-    return {-1, -1}; // Return invalid coordinates if the king is not found
+    int sq = pos.kingSq[WHITE];
+    if (sq == NO_SQUARE)
+        return {-1, -1}; // Return invalid coordinates if the king is not found
+    return {squareRow(sq), squareCol(sq)};
 }
 
 pair<int, int> Board::getBlackKingPosition()
 {
-    for (int i = 0; i < 8; ++i)
-    {
-        for (int j = 0; j < 8; ++j)
-        {
-            auto piece = board[i][j];
-            if (piece && piece->getSymbol() == 'k')
-            {
-                return {i, j};
-            }
-        }
-    }
-    return {-1, -1}; // If not found
+    int sq = pos.kingSq[BLACK];
+    if (sq == NO_SQUARE)
+        return {-1, -1}; // If not found
+    return {squareRow(sq), squareCol(sq)};
 }
 
 bool Board::movePiece(int startX, int startY, int endX, int endY)
 {
-    // Save the current board state before making the move (for undo functionality)
-    saveHistory();
+    // Ensure the move is within board bounds
+    if (startX < 0 || startX >= 8 || startY < 0 || startY >= 8 ||
+        endX < 0 || endX >= 8 || endY < 0 || endY >= 8)
+    {
+        cout << "Move is out of bounds!" << endl;
+        return false;
+    }
 
     if (!isSquareOccupied(startX, startY))
     {
@@ -340,210 +530,370 @@ bool Board::movePiece(int startX, int startY, int endX, int endY)
         return false;
     }
 
-    // Get the piece at the starting position
-    auto piece = board[startX][startY];
+    int from = toSquare(startX, startY);
+    int to = toSquare(endX, endY);
+    PieceCode piece = pieceAt(from);
+    PieceType type = typeOf(piece);
+    Color color = pieceColor(piece);
+    int flag = NORMAL_MOVE;
 
-    // Ensure the move is within board bounds
-    if (startX < 0 || startX >= 8 || startY < 0 || startY >= 8 ||
-        endX < 0 || endX >= 8 || endY < 0 || endY >= 8)
+    // Castling Logic: If the king moves two squares horizontally, check for castling
+    if (type == KING && abs(endY - startY) == 2)
     {
-        cout << "Move is out of bounds!" << endl;
-        return false;
+        if (!canCastle(startX, startY, endX, endY))
+        {
+            cout << "Castling conditions not met!" << endl;
+            return false;
+        }
+        flag = CASTLING;
     }
-
-    // Castling Logic: If the king moves two squares horizontally, check for castling
-    if ((piece->getSymbol() == 'K' || piece->getSymbol() == 'k') && abs(endY - startY) == 2)
+    else
     {
-        if (canCastle(startX, startY, endX, endY))
+        // Check if the move is valid for the piece
+        if (!isValidPieceMove(piece, startX, startY, endX, endY))
         {
-            // Determine castling side: kingside (endY > startY) or queenside (endY < startY)
-            bool isKingside = endY > startY;
-            int rookY = isKingside ? 7 : 0;
-
-            // Perform castling: Move the king and the rook
-            board[endX][endY] = piece;
-            board[startX][startY] = nullptr;
-            piece->setHasMoved(true);
-
-            int rookNewY = isKingside ? endY - 1 : endY + 1;
-            board[endX][rookNewY] = board[startX][rookY];
-            board[startX][rookY] = nullptr;
-            board[endX][rookNewY]->setHasMoved(true);
-
-            cout << "Castling performed successfully!" << endl;
-           // saveGameState();
-            return true;
+            cout << "Invalid move for " << pieceSymbol(piece) << "!" << endl;
+            return false;
         }
-        else
+
+        // Check if the path is clear for non-knight pieces
+        if (!isPathClear(startX, startY, endX, endY))
         {
-            cout << "Castling conditions not met!" << endl;
+            cout << "Path is blocked!" << endl;
             return false;
         }
+
+        if ((pieces(color) & squareBB(to)) != 0)
+        {
+            cout << "Cannot capture your own piece!" << endl;
+            return false;
+        }
+
+        if (type == PAWN)
+        {
+            // En Passant: a diagonal step onto the square behind a pawn that has just made a two-square move
+            if (to == pos.enPassantSquare && abs(startY - endY) == 1)
+                flag = EN_PASSANT;
+            else if (abs(startX - endX) == 2)
+                flag = DOUBLE_PAWN_PUSH;
+            // Handle pawn promotion
+            else if (endX == 0 || endX == 7)
+                flag = askPromotionChoice(color == WHITE);
+        }
     }
+    return playMove(Move(from, to, flag));
+}
 
-    // Check if the move is valid for the piece
-    if (!piece->isValidMove(startX, startY, endX, endY))
+bool Board::playMove(const Move &move)
+{
+    int from = move.from();
+    int to = move.to();
+    PieceCode piece = pieceAt(from);
+    Color color = pieceColor(piece);
+    if (piece == NO_PIECE)
     {
-        cout << "Invalid move for " << piece->getSymbol() << "!" << endl;
+        cout << "No piece at the starting position!" << endl;
         return false;
     }
 
-    // Check if the path is clear for non-knight pieces
-    if (!isPathClear(startX, startY, endX, endY))
+    // Only moves the legal generator produces are played, so the king is never left in check
+    MoveBuffer legalMoves;
+    generateLegalMoves(color, legalMoves);
+    bool isLegal = false;
+    for (int i = 0; i < legalMoves.size() && !isLegal; ++i)
+        isLegal = legalMoves[i] == move;
+    if (!isLegal)
     {
-        cout << "Path is blocked!" << endl;
+        if (isPseudoLegal(move) && !isLegalMove(move))
+            cout << "That move would leave your king in check!" << endl;
+        else
+            cout << "Invalid move for " << pieceSymbol(piece) << "!" << endl;
         return false;
     }
-    
-    // int kingX, kingY;
-    
-    // if (currentPlayer == 1)
-    // {
-    //     // Player 1's (White) turn - Check if Black's King is in check
-    //     tie(kingX, kingY) = getBlackKingPosition(); // Get Black King's position
-    //     cout << "Checking if Black King at (" << kingX << ", " << kingY << ") is in check." << endl;
-    //     // Add logic to check if Black's King is in check
-    //     if (checkmate->isCheckmate(kingX, kingY, *this)) {
-    //     cout << "Checkmate! Player White wins!" << endl;
-    //     return true; // Indicate game over
-    // // }
-    // // }
-    // if(currentPlayer == 2)
-    // {
-    //     // Player 2's (Black) turn - Check if White's King is in check
-    //     tie(kingX, kingY) = getWhiteKingPosition(); // Get White King's position
-    //     cout << "Checking if White King at (" << kingX << ", " << kingY << ") is in check." << endl;
-    //     // Add logic to check if White's King is in check
-    //     if (checkmate->isCheckmate(kingX, kingY, *this)) {
-    //     cout << "Checkmate! Player Black wins!" << endl;
-    //     return true; // Indicate game over
-    // }
-    //     }
-//     if (checkmate->isKingInCheck(kingX, kingY, *this)) {
-//     cout << "King is in check!" << endl;
-//     board[startX][startY] = piece; // Undo move if king is in check
-//     board[endX][endY] = nullptr;
-//     return false; // Return false to prevent further move
-// }
 
+    int startX = move.startX(), startY = move.startY();
+    int endX = move.endX(), endY = move.endY();
 
-    // // Check if the move results in checkmate
-    // if (checkmate->isCheckmate(kingX, kingY, *this))
-    // {
-    //     cout << "Checkmate! Player " << (isWhite ? "Black" : "White") << " wins!" << endl;
-    //     return true; // Indicate game over
-    // }
+    // Valid capture: Add the piece to the captured list
+    int capturedSq = move.flag() == EN_PASSANT ? toSquare(startX, endY) : to;
+    if (occupied() & squareBB(capturedSq))
+    {
+        capturedPieces.capturePiece(PIECE_NAMES[pieceTypeAt(capturedSq)], colorAt(capturedSq) == BLACK);
+    }
+
+    makeMove(move);
 
-    // Handle capturing an opponent's piece
-    if (isSquareOccupied(endX, endY))
+    // A new move invalidates the moves that were undone before it
+    while (!redoHistory.empty())
     {
-        auto targetPiece = board[endX][endY];
-        if (targetPiece->getColor() == piece->getColor())
-        {
-            cout << "Cannot capture your own piece!" << endl;
-            return false;
-        }
-        // Valid capture: Add the piece to the captured list
-        capturedPieces.capturePiece(targetPiece->getType(), targetPiece->isBlack());
-        board[endX][endY] = nullptr; // Clear the target square
-        //saveGameState();
+        redoHistory.pop();
     }
 
-    // Handle En Passant (for Pawn)
-    if (dynamic_cast<Pawn *>(piece.get()))
+    // Update the last move
+    updateLastMove(startX, startY, endX, endY, move.flag() == DOUBLE_PAWN_PUSH);
+
+    if (move.flag() == CASTLING)
+        cout << "Castling performed successfully!" << endl;
+    else if (move.flag() == EN_PASSANT)
+        cout << pieceSymbol(piece) << " captured en passant!" << endl;
+    else
     {
-        int direction = (piece->getColor() == 'w') ? -1 : 1; // White moves up, Black moves down
+        if (move.isPromotion())
+            cout << "Pawn promoted to " << pieceSymbol(makePiece(color, move.promotionType())) << "!" << endl;
+        cout << pieceSymbol(piece) << " moved from "
+             << startX << "," << startY << " to " << endX << "," << endY << "." << endl;
+    }
 
-        // Check for En Passant capture
-        if (abs(startY - endY) == 1 && abs(startX - endX) == 1)
-        {
-            if (lastMove.isTwoSquareMove && lastMove.endX == startX && endY == lastMove.startY)
-            { 
-                board[endX][endY] = piece;
-                board[startX][startY] = nullptr;
-                board[lastMove.endX][lastMove.endY] = nullptr;
-                capturedPieces.capturePiece(piece->getType(), piece->isBlack());
-                board[lastMove.endX][lastMove.endY] = nullptr;
-                cout << piece->getSymbol() << " captured en passant!" << endl;
-               // saveGameState();
-                updateLastMove(startX, startY, endX, endY, true);
-                return true;
-            }
-        }
+    return true;
+}
+
+void Board::makeMove(const Move &move)
+{
+    int from = move.from();
+    int to = move.to();
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    PieceCode piece = pos.mailbox[from];
+    PieceType type = typeOf(piece);
+    Color us = pieceColor(piece);
+
+    UndoRecord undo;
+    undo.move = move;
+    undo.capturedType = NO_PIECE_TYPE;
+    undo.castlingRights = pos.castlingRights;
+    undo.enPassantSquare = pos.enPassantSquare;
+    undo.halfmoveClock = pos.halfmoveClock;
+    undo.hashKey = pos.hashKey;
+    undo.attacked[WHITE] = pos.attackedBB[WHITE];
+    undo.attacked[BLACK] = pos.attackedBB[BLACK];
+
+    // Take out the parts of the key that may change, they are added back below
+    uint64_t key = pos.hashKey ^ ZOBRIST.castling[pos.castlingRights] ^ ZOBRIST.blackToMove;
+    if (pos.enPassantSquare != NO_SQUARE)
+        key ^= ZOBRIST.enPassantFile[squareCol(pos.enPassantSquare)];
+
+    // Remove the captured piece (for en passant it sits beside the target square)
+    int capturedSq = move.flag() == EN_PASSANT ? toSquare(move.startX(), move.endY()) : to;
+    PieceType captured = pieceTypeAt(capturedSq);
+    if (captured != NO_PIECE_TYPE)
+    {
+        undo.capturedType = captured;
+        pos.typeBB[captured] ^= squareBB(capturedSq);
+        pos.colorBB[opposite(us)] ^= squareBB(capturedSq);
+        key ^= ZOBRIST.piece[opposite(us)][captured][capturedSq];
+        pos.mailbox[capturedSq] = NO_PIECE;
+        --pos.pieceCounts[opposite(us)][captured];
     }
 
-    // Move the piece
-    board[endX][endY] = piece;
-    board[startX][startY] = nullptr;
+    pos.typeBB[type] ^= fromTo;
+    pos.colorBB[us] ^= fromTo;
+    pos.mailbox[from] = NO_PIECE;
+    pos.mailbox[to] = piece;
+    if (type == KING)
+        pos.kingSq[us] = to;
+    key ^= ZOBRIST.piece[us][type][from] ^ ZOBRIST.piece[us][type][to];
 
-    // Handle pawn promotion
-    if ((piece->getSymbol() == 'P' && endX == 0) || (piece->getSymbol() == 'p' && endX == 7))
+    if (move.isPromotion())
+    {
+        pos.typeBB[PAWN] ^= squareBB(to);
+        pos.typeBB[move.promotionType()] ^= squareBB(to);
+        pos.mailbox[to] = makePiece(us, move.promotionType());
+        --pos.pieceCounts[us][PAWN];
+        ++pos.pieceCounts[us][move.promotionType()];
+        key ^= ZOBRIST.piece[us][PAWN][to] ^ ZOBRIST.piece[us][move.promotionType()][to];
+    }
+    else if (move.flag() == CASTLING)
     {
-        promotePawn(endX, endY);
-       // saveGameState();
+        // The rook jumps to the square the king passed over
+        bool isKingside = move.endY() > move.startY();
+        int rookFrom = toSquare(move.startX(), isKingside ? 7 : 0);
+        int rookTo = toSquare(move.startX(), isKingside ? 5 : 3);
+        Bitboard rookFromTo = squareBB(rookFrom) | squareBB(rookTo);
+        pos.typeBB[ROOK] ^= rookFromTo;
+        pos.colorBB[us] ^= rookFromTo;
+        pos.mailbox[rookFrom] = NO_PIECE;
+        pos.mailbox[rookTo] = makePiece(us, ROOK);
+        key ^= ZOBRIST.piece[us][ROOK][rookFrom] ^ ZOBRIST.piece[us][ROOK][rookTo];
     }
 
-    // Update the last move
-    bool isTwoSquareMove = (abs(startX - endX) == 2); // Track if it's a two-square move
-    updateLastMove(startX, startY, endX, endY, isTwoSquareMove);
+    // The en-passant square is only recorded when an enemy pawn can actually use it,
+    // so positions that only differ by an unusable en-passant square hash the same
+    pos.enPassantSquare = NO_SQUARE;
+    if (move.flag() == DOUBLE_PAWN_PUSH && (pawnAttacks(us, (from + to) / 2) & pieces(opposite(us), PAWN)))
+    {
+        pos.enPassantSquare = (from + to) / 2;
+        key ^= ZOBRIST.enPassantFile[squareCol(pos.enPassantSquare)];
+    }
+    updateCastlingRights(from, to);
+    key ^= ZOBRIST.castling[pos.castlingRights];
+    pos.halfmoveClock = (type == PAWN || captured != NO_PIECE_TYPE) ? 0 : pos.halfmoveClock + 1;
+    if (us == BLACK)
+        ++pos.fullmoveNumber;
+    pos.sideToMove = opposite(pos.sideToMove);
+    pos.hashKey = key;
+    updateAttackMaps();
+
+    history.push(undo);
+}
+
+void Board::unmakeMove()
+{
+    const UndoRecord &undo = history.top();
+    const Move &move = undo.move;
+    int from = move.from();
+    int to = move.to();
+    Bitboard fromTo = squareBB(from) | squareBB(to);
+    PieceCode piece = pos.mailbox[to];
+    Color us = pieceColor(piece);
+
+    if (move.isPromotion())
+    {
+        pos.typeBB[move.promotionType()] ^= squareBB(to);
+        pos.typeBB[PAWN] ^= squareBB(to);
+        --pos.pieceCounts[us][move.promotionType()];
+        ++pos.pieceCounts[us][PAWN];
+        piece = makePiece(us, PAWN);
+    }
+    else if (move.flag() == CASTLING)
+    {
+        bool isKingside = move.endY() > move.startY();
+        int rookFrom = toSquare(move.startX(), isKingside ? 7 : 0);
+        int rookTo = toSquare(move.startX(), isKingside ? 5 : 3);
+        pos.typeBB[ROOK] ^= squareBB(rookFrom) | squareBB(rookTo);
+        pos.colorBB[us] ^= squareBB(rookFrom) | squareBB(rookTo);
+        pos.mailbox[rookTo] = NO_PIECE;
+        pos.mailbox[rookFrom] = makePiece(us, ROOK);
+    }
 
-    cout << piece->getSymbol() << " moved from "
-         << startX << "," << startY << " to " << endX << "," << endY << "." << endl;
+    pos.typeBB[typeOf(piece)] ^= fromTo;
+    pos.colorBB[us] ^= fromTo;
+    pos.mailbox[to] = NO_PIECE;
+    pos.mailbox[from] = piece;
+    if (typeOf(piece) == KING)
+        pos.kingSq[us] = from;
 
-    // // After the move, check if the king is still in check
-    // if (isKingInCheck(piece->getColor() == 'w'))  // Check if the current player's king is in check
-    // {
-    //     cout << "King is in check! Move is undone." << endl;
+    if (undo.capturedType != NO_PIECE_TYPE)
+    {
+        int capturedSq = move.flag() == EN_PASSANT ? toSquare(move.startX(), move.endY()) : to;
+        pos.typeBB[undo.capturedType] |= squareBB(capturedSq);
+        pos.colorBB[opposite(us)] |= squareBB(capturedSq);
+        pos.mailbox[capturedSq] = makePiece(opposite(us), PieceType(undo.capturedType));
+        ++pos.pieceCounts[opposite(us)][undo.capturedType];
+    }
 
-    //     // Undo the move if the king is still in check
-    //     undoMove();
-    //     return false; // Indicate the move is invalid due to the check
-    // }
+    pos.castlingRights = undo.castlingRights;
+    pos.enPassantSquare = undo.enPassantSquare;
+    pos.halfmoveClock = undo.halfmoveClock;
+    if (us == BLACK)
+        --pos.fullmoveNumber;
+    pos.hashKey = undo.hashKey;
+    pos.attackedBB[WHITE] = undo.attacked[WHITE];
+    pos.attackedBB[BLACK] = undo.attacked[BLACK];
+    pos.sideToMove = opposite(pos.sideToMove);
+
+    history.pop();
+}
 
+void Board::makeNullMove()
+{
+    UndoRecord undo;
+    undo.move = MOVE_NONE;
+    undo.capturedType = NO_PIECE_TYPE;
+    undo.castlingRights = pos.castlingRights;
+    undo.enPassantSquare = pos.enPassantSquare;
+    undo.halfmoveClock = pos.halfmoveClock;
+    undo.hashKey = pos.hashKey;
+    undo.attacked[WHITE] = pos.attackedBB[WHITE];
+    undo.attacked[BLACK] = pos.attackedBB[BLACK];
+
+    // The pieces stay put, so the attack maps do too. The en-passant right lapses, and
+    // no repetition can reach back past a pass.
+    pos.hashKey ^= ZOBRIST.blackToMove;
+    if (pos.enPassantSquare != NO_SQUARE)
+        pos.hashKey ^= ZOBRIST.enPassantFile[squareCol(pos.enPassantSquare)];
+    pos.enPassantSquare = NO_SQUARE;
+    pos.halfmoveClock = 0;
+    pos.sideToMove = opposite(pos.sideToMove);
+
+    history.push(undo);
+}
 
-    return true;
+void Board::unmakeNullMove()
+{
+    const UndoRecord &undo = history.top();
+    pos.enPassantSquare = undo.enPassantSquare;
+    pos.halfmoveClock = undo.halfmoveClock;
+    pos.hashKey = undo.hashKey;
+    pos.sideToMove = opposite(pos.sideToMove);
+    history.pop();
 }
 
-bool Board::isKingInCheck(bool isWhite) const
+// Bare kings, a single minor piece, or bishops that all stand on one square color
+bool Board::isInsufficientMaterial() const
 {
-    int kingX = -1, kingY = -1;
+    if (pos.typeBB[PAWN] | pos.typeBB[ROOK] | pos.typeBB[QUEEN])
+        return false;
+    if (popCount(pos.typeBB[KNIGHT] | pos.typeBB[BISHOP]) <= 1)
+        return true;
+    Bitboard bishops = pos.typeBB[BISHOP];
+    return !pos.typeBB[KNIGHT] && (!(bishops & LIGHT_SQUARES_BB) || !(bishops & ~LIGHT_SQUARES_BB));
+}
 
-    // Locate the king
-    for (int y = 0; y < 8; ++y)
+// How often the current position has occurred, this time included. Only the positions
+// since the last capture or pawn move can match, and only every second one has the
+// same side to move.
+int Board::repetitionCount() const
+{
+    int count = 1;
+    int plies = int(history.size());
+    int reversible = min(pos.halfmoveClock, plies);
+    for (int back = 2; back <= reversible; back += 2)
     {
-        for (int x = 0; x < 8; ++x)
-        {
-            shared_ptr<Piece> piece = board[y][x];
-            if (piece && piece->getSymbol() == (isWhite ? 'K' : 'k'))
-            {
-                kingX = x;
-                kingY = y;
-                break;
-            }
-        }
+        if (history.at(plies - back).hashKey == pos.hashKey)
+            ++count;
     }
+    return count;
+}
+
+GameStatus Board::status() const
+{
+    // The draw rules first: they are only counts, and a repeated or material-drawn
+    // position cannot be mate anyway
+    if (isInsufficientMaterial())
+        return DRAW_INSUFFICIENT_MATERIAL;
+    if (pos.halfmoveClock >= 4 && repetitionCount() >= 3)
+        return DRAW_REPETITION;
+    if (!hasLegalMove())
+        return inCheck() ? CHECKMATE : STALEMATE;
+    // Checkmate on the hundredth half-move still counts, so this comes last
+    if (pos.halfmoveClock >= 100)
+        return DRAW_FIFTY_MOVES;
+    return ONGOING;
+}
+
+bool Board::isKingInCheck(bool isWhite) const
+{
+    int sq = pos.kingSq[colorOf(isWhite)];
 
     // If king isn't found, return false or handle it appropriately
-    if (kingX == -1 || kingY == -1)
+    if (sq == NO_SQUARE)
         return false; // King not found, cannot be in check
 
     // Check if the king's position is under attack
-    return isKingUnderAttack(kingX, kingY, !isWhite);
-}
-
-void Board::resetAttackFlags() {
-    for (int x = 0; x < 8; ++x) {
-        for (int y = 0; y < 8; ++y) {
-            getSquare(x, y).isUnderAttack = false; // Reset each square's attack status
-        }
-    }
+    return isSquareAttacked(sq, colorOf(!isWhite));
 }
 
 
 // In Board.cpp
 vector<vector<shared_ptr<Piece>>> Board::getBoard() const
 {
-    return board; // Return the internal board representation
+    // Expand the bitboards into the 2D piece grid used by the older interfaces
+    vector<vector<shared_ptr<Piece>>> grid(8, vector<shared_ptr<Piece>>(8, nullptr));
+    for (Bitboard occ = occupied(); occ;)
+    {
+        int sq = popLsb(occ);
+        grid[squareRow(sq)][squareCol(sq)] = pieceFacade(pos.mailbox[sq]);
+    }
+    return grid;
 }
 
 shared_ptr<Piece> Board::getPiece(int row, int col) const
@@ -553,12 +903,7 @@ shared_ptr<Piece> Board::getPiece(int row, int col) const
         cout << "Out of bounds access at row: " << row << ", col: " << col << endl;
         return nullptr;
     }
-    // if (board[row][col] == nullptr) {
-    //     cout << "No piece at row: " << row << ", col: " << col << endl;
-    // } else {
-    //     cout << "Piece found at row: " << row << ", col: " << col << endl;
-    // }
-    return board[row][col];
+    return pieceFacade(pos.mailbox[toSquare(row, col)]);
 }
 
 pair<int, int> convertToIndex(const string &position)
@@ -599,224 +944,103 @@ void Board::updateLastMove(int startX, int startY, int endX, int endY, bool isTw
     lastMove.isTwoSquareMove = isTwoSquareMove;
 
     // Check if a piece is captured, if yes, store it in pieceCaptured
-    if (board[endX][endY] != nullptr)
-    {
-        lastMove.pieceCaptured = board[endX][endY]; // Piece at the destination is captured
-    }
-    else
-    {
-        lastMove.pieceCaptured = nullptr; // No capture
-    }
-    // cout << "Last move: Start (" << lastMove.startX << ", " << lastMove.startY << ") -> End (" << lastMove.endX << ", " << lastMove.endY << ")" << endl
-    //      << isTwoSquareMove << endl;
+    lastMove.pieceCaptured = pieceAt(toSquare(endX, endY));
 }
 
-void Board::promotePawn(int x, int y)
+// Asks which piece a pawn reaching the last row becomes and returns the matching MoveFlag
+int Board::askPromotionChoice(bool isWhitePawn) const
 {
-    // Check if the piece at the position is a pawn
-    if (!board[x][y] || (board[x][y]->getSymbol() != 'P' && board[x][y]->getSymbol() != 'p'))
-    {
-        cout << "No pawn at the promotion position!" << endl;
-        return;
-    }
-
-    // Determine if the pawn is white or black
-    bool isWhitePawn = board[x][y]->getColor(); // Using getColor() instead of checking symbol
-
-    // Ensure the pawn is in the promotion row
-    if ((isWhitePawn && x != 0) || (!isWhitePawn && x != 7))
-    {
-        cout << "The pawn hasn't reached the promotion rank!" << endl;
-        return;
-    }
-
     // Prompt for promotion piece choice
-    cout << "Promote pawn at (" << x << ", " << y << "). Choose promotion piece (Q/R/B/N for white, q/r/b/n for black): ";
+    cout << "Choose promotion piece (Q/R/B/N for white, q/r/b/n for black): ";
     char promotionChoice;
     cin >> promotionChoice;
 
-    // Validate the promotion choice based on the pawn's color
-    shared_ptr<Piece> newPiece;
-
-    if (isWhitePawn)
+    // Validate the promotion choice (the pawn keeps its own color either way)
+    switch (toupper(promotionChoice))
     {
-        // For white pawn (Player 1), create white pieces
-        switch (toupper(promotionChoice))
-        {
-        case 'Q':
-            newPiece = make_shared<Queen>(true);
-            break; // White Queen
-        case 'R':
-            newPiece = make_shared<Rook>(true);
-            break; // White Rook
-        case 'B':
-            newPiece = make_shared<Bishop>(true);
-            break; // White Bishop
-        case 'N':
-            newPiece = make_shared<Knight>(true);
-            break; // White Knight
-        default:
-            cout << "Invalid promotion choice for white. Defaulting to Queen." << endl;
-            newPiece = make_shared<Queen>(true); // Default to White Queen
-            break;
-        }
+    case 'Q':
+        return PROMOTE_QUEEN;
+    case 'R':
+        return PROMOTE_ROOK;
+    case 'B':
+        return PROMOTE_BISHOP;
+    case 'N':
+        return PROMOTE_KNIGHT;
+    default:
+        cout << "Invalid promotion choice for " << (isWhitePawn ? "white" : "black") << ". Defaulting to Queen." << endl;
+        return PROMOTE_QUEEN;
     }
-    else
-    {
-        // For black pawn (Player 2), create black pieces
-        switch (tolower(promotionChoice))
-        {
-        case 'q':
-            newPiece = make_shared<Queen>(false);
-            break; // Black Queen
-        case 'r':
-            newPiece = make_shared<Rook>(false);
-            break; // Black Rook
-        case 'b':
-            newPiece = make_shared<Bishop>(false);
-            break; // Black Bishop
-        case 'n':
-            newPiece = make_shared<Knight>(false);
-            break; // Black Knight
-        default:
-            cout << "Invalid promotion choice for black. Defaulting to Queen." << endl;
-            newPiece = make_shared<Queen>(false); // Default to Black Queen
-            break;
-        }
-    }
-
-    // Replace the pawn with the promoted piece
-    board[x][y] = newPiece;
-
-    cout << "Pawn promoted to " << newPiece->getSymbol() << "!" << endl;
 }
 
 bool Board::canCastle(int startX, int startY, int endX, int endY) const
 {
-    shared_ptr<Piece> king = board[startX][startY];
-    if (!king || (king->getSymbol() != 'K' && king->getSymbol() != 'k'))
+    int kingFrom = toSquare(startX, startY);
+    if (pieceTypeAt(kingFrom) != KING)
     {
         cout << "Not a king!" << endl;
         return false;
     }
-    if (king->getHasMoved())
+    Color color = colorAt(kingFrom);
+
+    bool isKingside = (endY > startY);
+    int right = color == WHITE ? (isKingside ? WHITE_KINGSIDE : WHITE_QUEENSIDE)
+                               : (isKingside ? BLACK_KINGSIDE : BLACK_QUEENSIDE);
+    if (!(pos.castlingRights & right))
     {
+        // Either the king or this rook has already moved
         cout << "King has already moved!" << endl;
         return false;
     }
 
-    bool isKingside = (endY > startY);
     int rookY = isKingside ? 7 : 0;
-    shared_ptr<Piece> rook = board[startX][rookY];
-    if (!rook || rook->getSymbol() != 'R' && rook->getSymbol() != 'r' || rook->getHasMoved())
+    int rookSq = toSquare(startX, rookY);
+    if (!(pieces(color, ROOK) & squareBB(rookSq)))
     {
         cout << "Invalid rook for castling!" << endl;
         return false;
     }
 
     // Ensure no pieces between the king and rook
-    int step = isKingside ? 1 : -1;
-    for (int y = startY + step; y != rookY; y += step)
+    if (betweenBB(kingFrom, rookSq) & occupied())
     {
-        if (board[startX][y])
-        {
-            cout << "Path blocked at " << startX << "," << y << "!" << endl;
-            return false;
-        }
+        cout << "Path blocked between " << startX << "," << startY << " and " << startX << "," << rookY << "!" << endl;
+        return false;
     }
 
     // Ensure squares the king moves through are not under attack
-    for (int y = startY; y != endY + step; y += step)
+    int step = isKingside ? 1 : -1;
+    for (int y = startY + step; y != endY + step; y += step)
     {
-        if (y != startY)
+        // Check if the square is under attack
+        if (isSquareUnderAttack(startX, y, color == WHITE))
         {
-            // Check if the square is under attack
-            if (isSquareUnderAttack(startX, y, king->getColor()))
-            {
-                cout << "Square " << startX << "," << y << " is under attack!" << endl;
-                return false;
-            }
+            cout << "Square " << startX << "," << y << " is under attack!" << endl;
+            return false;
         }
     }
 
     return true;
 }
 
-bool Board::isSquareUnderAttack(int x, int y, bool color) const
+Bitboard Board::attackersTo(int sq, Bitboard occupancy) const
 {
-    cout << "Checking square: " << x << "," << y << endl;
-    for (int i = 0; i < 8; i++)
-    {
-        for (int j = 0; j < 8; j++)
-        {
-            shared_ptr<Piece> attacker = board[i][j];
-            if (attacker && attacker->getColor() != color)
-            {
-                // Check if the attacker can move to (x, y)
-                if (attacker->isValidMove(i, j, x, y))
-                {
-                    // For long-range pieces (Q, R, B), ensure they are not blocking the path
-                    if (attacker->getSymbol() == 'Q' || attacker->getSymbol() == 'R' || attacker->getSymbol() == 'B')
-                    {
-                        if (!isPathClear(i, j, x, y))
-                        {
-                            continue; // Path is not clear, invalid move
-                        }
-                    }
-
-                    // Skip attacking squares if they are not on the castling path
-                    if (x == 7 && y == 3)
-                    { // For d1 (7,3)
-                        if (attacker->getSymbol() == 'q' && i == 0 && j == 3)
-                        { // If the piece is the queen on d1 itself, skip
-                            continue;
-                        }
-                    }
-                    return true; // Square is under attack
-                }
-            }
-        }
-    }
-    return false; // No attackers found
+    return (pawnAttacks(BLACK, sq) & pieces(WHITE, PAWN)) |
+           (pawnAttacks(WHITE, sq) & pieces(BLACK, PAWN)) |
+           (knightAttacks(sq) & pos.typeBB[KNIGHT]) |
+           (kingAttacks(sq) & pos.typeBB[KING]) |
+           (rookAttacks(sq, occupancy) & (pos.typeBB[ROOK] | pos.typeBB[QUEEN])) |
+           (bishopAttacks(sq, occupancy) & (pos.typeBB[BISHOP] | pos.typeBB[QUEEN]));
 }
 
-bool Board::isKingUnderAttack(int x, int y, bool byWhite) const
+// color is the defending side: the square is attacked if any enemy piece reaches it
+bool Board::isSquareUnderAttack(int x, int y, bool color) const
 {
-    for (int i = 0; i < 8; ++i)
-    {
-        for (int j = 0; j < 8; ++j)
-        {
-            shared_ptr<Piece> piece = board[i][j];
-            // Use getColor() instead of accessing isWhite directly
-            if (piece && piece->getColor() == byWhite && piece->isValidMove(j, i, x, y))
-            {
-                return true;
-            }
-        }
-    }
-    return false;
+    return isSquareAttacked(toSquare(x, y), colorOf(!color));
 }
 
-void Board::saveHistory()
+bool Board::isKingUnderAttack(int x, int y, bool byWhite) const
 {
-    // Create a new vector to store the current state of the board.
-    vector<vector<shared_ptr<Piece>>> currentState;
-
-    // Iterate through each square on the board and store the current piece.
-    for (int row = 0; row < 8; ++row)
-    {
-        vector<shared_ptr<Piece>> rowState;
-        for (int col = 0; col < 8; ++col)
-        {
-            // Add the piece at the current position to the row.
-            rowState.push_back(board[row][col]);
-        }
-        // Add the row to the current state.
-        currentState.push_back(rowState);
-    }
-
-    // Push the current state onto the history stack.
-    history.push(currentState);
+    return isSquareAttacked(toSquare(x, y), colorOf(byWhite));
 }
 
 void Board::undoMove()
@@ -824,21 +1048,9 @@ void Board::undoMove()
     // Check if there is a move to undo (i.e., the history stack is not empty).
     if (!history.empty())
     {
-        // Save the current state to redoHistory for potential redo.
-        redoHistory.push(board);
-        // Pop the top state from the history stack.
-        vector<vector<shared_ptr<Piece>>> previousState = history.top();
-        history.pop();
-
-        // Restore the board to the previous state.
-        for (int row = 0; row < 8; ++row)
-        {
-            for (int col = 0; col < 8; ++col)
-            {
-                // Set the board piece back to the previous state.
-                board[row][col] = previousState[row][col];
-            }
-        }
+        // Keep the move so it can be redone, then take it back
+        redoHistory.push(history.top().move);
+        unmakeMove();
     }
     else
     {
@@ -850,21 +1062,10 @@ bool Board::redoMove()
 {
     if (!redoHistory.empty())
     {
-        // Save the current state to history for potential undo.
-        history.push(board);
-
-        // Restore the next state from redoHistory (using stack's pop)
-        vector<vector<shared_ptr<Piece>>> nextState = redoHistory.top();
+        // Replay the most recently undone move
+        Move move = redoHistory.top();
         redoHistory.pop();
-
-        // Update the board with the next state
-        for (int row = 0; row < 8; ++row)
-        {
-            for (int col = 0; col < 8; ++col)
-            {
-                board[row][col] = nextState[row][col];
-            }
-        }
+        makeMove(move);
 
         // Optionally print a message
         cout << "Move redone!" << endl;
@@ -1259,22 +1460,11 @@ string Board::convertToPosition(int x, int y) {
 // Board method to get possible moves for a piece at a given position
 vector<pair<int, int>> Board::getPossibleMoves(int startX, int startY) const
 {
-    vector<pair<int, int>> moves;
-
-    // Check if the square is occupied
-    if (!isSquareOccupied(startX, startY))
-    {
-        return moves; // Return an empty list if no piece exists
-    }
-
-    // Retrieve the piece at the specified position
-    shared_ptr<Piece> piece = getPiece(startX, startY);
-    if (piece)
-    {
-        moves = piece->getLegalMoves(startX, startY, *this);
-    }
-
-    return moves;
+    // An empty square has no moves
+    PieceCode piece = pieceAt(toSquare(startX, startY));
+    if (piece == NO_PIECE)
+        return {};
+    return pieceMoveList(piece, startX, startY, *this);
 }
 
 
@@ -11,53 +11,160 @@
 #include "Stack.h"
 #include "Queue.h"
 #include "CapturedPieceList.h"
+#include "Bitboard.h"
+#include "Move.h"
+#include "Position.h"
+#include "Zobrist.h"
 
 
 
 using namespace std;
 
 class Piece;
-class Square;
 class Checkmate;
 
+// Result of the position on the board for the side to move
+enum GameStatus
+{
+    ONGOING,
+    CHECKMATE,                  // The side to move is mated
+    STALEMATE,
+    DRAW_FIFTY_MOVES,           // 100 half-moves without a capture or pawn move
+    DRAW_REPETITION,            // The same position for the third time
+    DRAW_INSUFFICIENT_MATERIAL  // Neither side can possibly mate
+};
+
+// Everything makeMove() cannot recompute when taking a move back.
+// Plain data: one small record per ply instead of a copy of the board.
+struct UndoRecord
+{
+    Move move;
+    int8_t capturedType;    // PieceType removed by the move, NO_PIECE_TYPE if none
+    int8_t castlingRights;  // Rights before the move
+    int8_t enPassantSquare; // En-passant square before the move
+    int16_t halfmoveClock;  // Fifty-move counter before the move
+    uint64_t hashKey;       // Zobrist key before the move
+    Bitboard attacked[2];   // Attack maps before the move
+};
+
+// Struct to track the last move made on the board
+struct LastMove
+{
+    int startX, startY;
+    int endX, endY;
+    bool isTwoSquareMove;
+    PieceCode pieceCaptured; // Piece on the target square when the move was recorded
+};
 
-// Class representing the Chessboard
+// Class representing the Chessboard.
+// All game state lives in the instance, so separate boards can be used from
+// different threads at the same time without locking.
 class Board
 {
 private:
-    vector<vector<shared_ptr<Piece>>> board; // 2D vector of smart pointers to pieces
-    // Stack to store history of board states (for undo functionality)
-    Stack<vector<vector<shared_ptr<Piece>>>> history;
-    Checkmate *checkmate; // Add Checkmate as a member of Board class
+    Position pos; // The position itself; everything below is history and bookkeeping
+    // Stack of undo records, one per move played (for undo functionality)
+    Stack<UndoRecord> history;
+    Stack<Move> redoHistory; // Moves taken back with undoMove(), most recent on top
+    LastMove lastMove;       // Last move played through movePiece()
+
+    void clearBoard();
+    void clearHistory(); // Undo and redo stacks and the last move
+    void putPiece(int sq, Color color, PieceType type);
+    void updateCastlingRights(int from, int to);
+    void updateAttackMaps();
+    int askPromotionChoice(bool isWhitePawn) const;
+    bool isInsufficientMaterial() const;
+    int repetitionCount() const;
     // GameState currentGameState;  // Current game state
 
 public:
-    // New 2D vector of Squares
-    vector<vector<Square>> squareBoard;
     Board(); // Constructor
     CapturedPieceList capturedPieces;
 
+    // Compatibility facade: one shared Piece object per piece code, nullptr on an empty square
     shared_ptr<Piece> getPiece(int x, int y) const;
+
+    // Bitboard accessors
+    Bitboard pieces(Color color) const { return pos.colorBB[color]; }
+    Bitboard pieces(PieceType type) const { return pos.typeBB[type]; }
+    Bitboard pieces(Color color, PieceType type) const { return pos.colorBB[color] & pos.typeBB[type]; }
+    Bitboard occupied() const { return pos.colorBB[WHITE] | pos.colorBB[BLACK]; }
+    PieceCode pieceAt(int sq) const { return pos.mailbox[sq]; }            // NO_PIECE on an empty square
+    PieceType pieceTypeAt(int sq) const { return typeOf(pos.mailbox[sq]); } // NO_PIECE_TYPE on an empty square
+    Color colorAt(int sq) const { return pieceColor(pos.mailbox[sq]); }    // Only meaningful on an occupied square
+    int kingSquare(Color color) const { return pos.kingSq[color]; }        // NO_SQUARE without a king
+    int pieceCount(Color color, PieceType type) const { return pos.pieceCounts[color][type]; }
+    // True if the side to move is in check
+    bool inCheck() const { return pos.kingSq[pos.sideToMove] != NO_SQUARE && isSquareAttacked(pos.kingSq[pos.sideToMove], opposite(pos.sideToMove)); }
+    int getCastlingRights() const { return pos.castlingRights; }
+    int getEnPassantSquare() const { return pos.enPassantSquare; }
+    Color getSideToMove() const { return pos.sideToMove; }
+    int getHalfmoveClock() const { return pos.halfmoveClock; }
+    // Zobrist key identifying the position: pieces, castling rights, en-passant file and side to move
+    uint64_t getHashKey() const { return pos.hashKey; }
+    uint64_t computeHashKey() const; // Recomputed from scratch, for checking the incremental key
+    // All pieces of both colors attacking sq, given the occupancy
+    Bitboard attackersTo(int sq, Bitboard occupancy) const;
+    // Every square attacked by a side: pieces still "attack" squares held by their own side
+    Bitboard attacks(Color by) const { return pos.attackedBB[by]; }
+    Bitboard computeAttacks(Color by) const; // Recomputed from scratch, for checking the maps
+    bool isSquareAttacked(int sq, Color by) const { return (pos.attackedBB[by] & squareBB(sq)) != 0; }
+
+    // Move generation (MoveGen.cpp). All of it appends to the caller's buffer and never allocates.
+    // The generators are templated on the side and the stage, so pawn directions,
+    // promotion rows and castling squares are compile-time constants.
+    void generateMoves(Color side, MoveBuffer &moves) const;      // Pseudo-legal moves
+    void generateMoves(GenType type, MoveBuffer &moves) const;    // One stage, pseudo-legal, for the side to move
+    // Legal moves only: checkers and pinned pieces are worked out once per call, so no move is tried out
+    void generateLegalMoves(Color side, MoveBuffer &moves) const;
+    void generateLegalMoves(GenType type, MoveBuffer &moves) const; // One stage, legal, for the side to move
+    bool isLegalMove(const Move &move) const;                     // For a pseudo-legal move of the side owning the piece
+    // True if the generator could produce this move for the side to move (legal or not),
+    // for moves that come from elsewhere, such as the hash table or the killer slots
+    bool isPseudoLegal(const Move &move) const;
+    // Stops at the first legal move found: a king step or a piece that is not pinned settles
+    // it without generating anything; only in check are the evasions generated
+    bool hasLegalMove() const;
+    // Checkmate, stalemate or a draw by rule, otherwise ONGOING. Cheap enough to call after every move:
+    // the draw rules are simple counts and only a side without king moves needs a full generation.
+    GameStatus status() const;
     void setupBoard();                                                  // Sets up initial board state
+    // Sets up the position described by a FEN string. Returns false (board unchanged) if it cannot be parsed.
+    bool loadFEN(const string &fen);
+    string getFEN() const;
+    // The position as a plain value, e.g. to snapshot it or hand it to a search thread
+    const Position &position() const { return pos; }
+    // Replaces the position and forgets the move history (nothing left to undo or redo)
+    void setPosition(const Position &position);
     void printBoard() const;                                            // Prints the board to the console
     bool isSquareOccupied(int x, int y) const;                          // Checks if a square is occupied
     bool isPathClear(int startX, int startY, int endX, int endY) const; // Checks if path is clear for non-knight moves
     // void buildAdjacencyList(vector<vector<int>>& adjList) const;
     bool movePiece(int startX, int startY, int endX, int endY); // Moves a piece
+    // Plays a move that came as a Move (e.g. from the AI), promotion piece included. Like
+    // movePiece() it is checked against the legal moves first and returns false if illegal.
+    bool playMove(const Move &move);
     void updateLastMove(int startX, int startY, int endX, int endY, bool isTwoSquareMove);
-    void promotePawn(int x, int y);
+    const LastMove &getLastMove() const { return lastMove; }
     bool isSquareUnderAttack(int x, int y, bool color) const;
     bool canCastle(int startX, int startY, int endX, int endY) const;
+    // Plays a move produced by the move generator (no validation, no console output)
+    void makeMove(const Move &move);
+    // Takes back the last move played with makeMove()
+    void unmakeMove();
+    // Passes the turn without moving, for null-move pruning. previousMove() is MOVE_NONE
+    // until it is taken back with unmakeNullMove().
+    void makeNullMove();
+    void unmakeNullMove();
     // Undo the last move
     void undoMove();
     bool redoMove();
-    // Function to track the current state of the board and push it to the history stack
-    void saveHistory();
     vector<pair<int, int>> getPossibleMoves(int startX, int startY) const;
     bool isRedoEmpty() const;
     int getHistorySize() const;
-void resetAttackFlags();
-    Square &getSquare(int x, int y);
+    // The move that led to this position, MOVE_NONE at the start of the history
+    Move previousMove() const { return history.empty() ? MOVE_NONE : history.at(history.size() - 1).move; }
     pair<int, int> getWhiteKingPosition();
     pair<int, int> getBlackKingPosition();
     // Function to return the board (access to the internal 2D vector of shared_ptr<Piece>)
@@ -80,16 +187,6 @@ void resetAttackFlags();
 // Converts chess notation (e.g., "e2") to board indices
 pair<int, int> convertToIndex(const string &position);
 
-// Struct to track the last move made on the board
-struct LastMove
-{
-    int startX, startY;
-    int endX, endY;
-    bool isTwoSquareMove;
-    shared_ptr<Piece> pieceCaptured; // Change to shared_ptr<Piece>  Assuming Piece is the class or struct that represents a chess piece
-};
-
-extern LastMove lastMove;
 
 // struct GameState {
 //     std::vector<std::vector<std::shared_ptr<Piece>>> board;  // 8x8 board
@@ -6,7 +6,24 @@ using namespace std;
 CapturedPieceList::CapturedPieceList() 
     : blackHead(nullptr), blackTail(nullptr), whiteHead(nullptr), whiteTail(nullptr) {}
 
+CapturedPieceList::CapturedPieceList(const CapturedPieceList& other)
+    : blackHead(nullptr), blackTail(nullptr), whiteHead(nullptr), whiteTail(nullptr) {
+    copyFrom(other);
+}
+
+CapturedPieceList& CapturedPieceList::operator=(const CapturedPieceList& other) {
+    if (this != &other) {
+        clear();
+        copyFrom(other);
+    }
+    return *this;
+}
+
 CapturedPieceList::~CapturedPieceList() {
+    clear();
+}
+
+void CapturedPieceList::clear() {
     // Clean up memory by deleting all nodes in the list for black and white pieces
     CapturedPieceNode* current = blackHead;
     while (current) {
@@ -21,6 +38,18 @@ CapturedPieceList::~CapturedPieceList() {
         current = current->next;
         delete temp;
     }
+
+    blackHead = blackTail = whiteHead = whiteTail = nullptr;
+}
+
+void CapturedPieceList::copyFrom(const CapturedPieceList& other) {
+    // Appending in order rebuilds both lists with the same contents
+    for (CapturedPieceNode* current = other.blackHead; current; current = current->next) {
+        capturePiece(current->pieceType, true);
+    }
+    for (CapturedPieceNode* current = other.whiteHead; current; current = current->next) {
+        capturePiece(current->pieceType, false);
+    }
 }
 
 void CapturedPieceList::capturePiece(const std::string& pieceType, bool isBlack) {
@@ -19,6 +19,8 @@ struct CapturedPieceNode {
 class CapturedPieceList {
 public:
     CapturedPieceList();                      // Constructor
+    CapturedPieceList(const CapturedPieceList& other); // Deep copy, so a copied Board owns its own list
+    CapturedPieceList& operator=(const CapturedPieceList& other);
     ~CapturedPieceList();                     // Destructor
     void capturePiece(const std::string& pieceType, bool isBlack); // Capture a piece
     void restoreLastCapturedPiece();          // Restore the last captured piece
@@ -26,6 +28,9 @@ public:
     bool isCapturedPieceListEmpty() const;    // Check if the captured list is empty
 
 private:
+    void clear();                             // Deletes every node of both lists
+    void copyFrom(const CapturedPieceList& other);
+
     CapturedPieceNode* blackHead;             // Head for black captured pieces list
     CapturedPieceNode* blackTail;             // Tail for black captured pieces list
     CapturedPieceNode* whiteHead;             // Head for white captured pieces list
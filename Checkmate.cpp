@@ -1,4 +1,4 @@
-#include "checkmate.h"
+#include "Checkmate.h"
 #include "Board.h"
 #include "AI.h"
 #include "Piece.h"
@@ -119,58 +119,19 @@ class Board;
 //     return true; // The king is in check and cannot be saved, so it's checkmate
 // }
 
-// Default constructor
-Square::Square() : x(0), y(0), piece('.'), isUnderAttack(false) {}
-
-// Constructor with arguments
-Square::Square(int x, int y, char piece) : x(x), y(y), piece(piece), isUnderAttack(false) {}
-
-
-Checkmate::Checkmate(const vector<vector<shared_ptr<Piece>>>& board) {
-    // Initialize the boardSquares to the size of the passed board
-    // The board is 8x8, so we resize the boardSquares accordingly.
-    boardSquares.resize(8, vector<shared_ptr<Piece>>(8, nullptr));
-
-    // Copy the pieces from the input board to boardSquares
-    for (int i = 0; i < 8; ++i) {
-        for (int j = 0; j < 8; ++j) {
-            // Copy each piece from the input board into boardSquares
-            if (board[i][j] != nullptr) {
-                // If there's a piece, copy it over
-                boardSquares[i][j] = board[i][j];
-            }
-        }
-    }
-}
-
-
 bool Checkmate::isKingInCheck(int kingX, int kingY, Board &board) {
     // Loop through all pieces on the board
 
     cout << "Checking if King at (" << kingX << ", " << kingY << ") is in check." << endl;
-    
-    for (int x = 0; x < 8; ++x) {
-        for (int y = 0; y < 8; ++y) {
-            shared_ptr<Piece> piece = boardSquares[x][y]; // Get the piece at the current square
-
-            // Only consider opponent pieces
-            if (piece != nullptr && piece->getColor() != boardSquares[kingX][kingY]->getColor()) {
-                // Pass the Board reference to markAttacks()
-                piece->markAttacks(x, y, board);  // Passing the Board reference
-
-                // If the King's position is under attack, return true
-                if (board.getSquare(kingX, kingY).isUnderAttack) {
-                    return true;  // The King is in check
-                }
-            }
-        }
-    }
 
-    // If no attacks were found, the King is not in check
-    return false;  // The King is not in check
+    // The King is in check if the opponent attacks its square
+    Color kingColor = board.colorAt(toSquare(kingX, kingY));
+    return board.isSquareAttacked(toSquare(kingX, kingY), opposite(kingColor));
 }
 
 bool Checkmate::canKingEscape(int kingX, int kingY, Board &board) {
+    Color kingColor = board.colorAt(toSquare(kingX, kingY));
+
     // Check all adjacent squares around the King
     for (int dx = -1; dx <= 1; ++dx) {
         for (int dy = -1; dy <= 1; ++dy) {
@@ -182,16 +143,16 @@ bool Checkmate::canKingEscape(int kingX, int kingY, Board &board) {
 
             // Check if the new position is within bounds
             if (newX >= 0 && newX < 8 && newY >= 0 && newY < 8) {
-                shared_ptr<Piece> pieceAtNewSquare = board.getPiece(newX, newY);
+                PieceCode pieceAtNewSquare = board.pieceAt(toSquare(newX, newY));
 
                 // Ensure the King does not move to a square occupied by its own piece
-                if (pieceAtNewSquare != nullptr && pieceAtNewSquare->getColor() == boardSquares[kingX][kingY]->getColor()) {
+                if (pieceAtNewSquare != NO_PIECE && pieceColor(pieceAtNewSquare) == kingColor) {
                     continue;  // Skip if there's a friendly piece
                 }
                 cout << "Checking escape at (" << newX << ", " << newY << ")" << endl;
 
-                // Check if the square is under attack by checking the 'isUnderAttack' flag in the Square
-                if (!board.getSquare(newX, newY).isUnderAttack) {
+                // Check if the square is under attack by the opponent
+                if (!board.isSquareAttacked(toSquare(newX, newY), opposite(kingColor))) {
                     // If the King can move to this square and it's not under attack, return true (escape is possible)
                     return true;
                 }
@@ -42,30 +42,15 @@ class Piece;
 // };
 
 // checkmate.h
-class Square {
-public:
-    int x, y;              // Position on the board
-    bool isUnderAttack;    // Whether this square is under attack
-    char piece;            // Store the piece (could be 'K' for King, 'Q' for Queen, etc.)
-
-    // Default constructor
-    Square();
-
-    // Constructor with arguments
-    Square(int x, int y, char piece = '.');
-};
-
+// Attacked squares come from the board's attack maps (Board::isSquareAttacked)
 class Checkmate {
 public:
-   // Constructor that accepts a reference to the board
-    Checkmate(const vector<vector<shared_ptr<Piece>>>& board);
+    Checkmate() {}
 
     bool isKingInCheck(int kingX, int kingY, Board &board); // Check if the King is in check
     bool isCheckmate(int kingX, int kingY, Board &board); // Check for checkmate
 
 private:
-    vector<vector<shared_ptr<Piece>>> boardSquares;  // Store the board in Checkmate
-
     //Moved funciton to the Piece class
     // void markAttacks();  // Function to mark all squares under attack
 
@@ -0,0 +1,13 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+#include "Board.h"
+
+// Material values in centipawns, indexed by PieceType (the king is never traded)
+const int PIECE_VALUES[6] = {100, 320, 330, 500, 900, 0};
+
+// Static evaluation in centipawns from the point of view of the side to move:
+// material plus piece-square bonuses
+int evaluate(const Board &board);
+
+#endif // EVALUATION_H
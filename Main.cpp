@@ -1,4 +1,5 @@
 #include <iostream>
+#include <thread>
 #include "Board.h"
 #include "AI.h"
 #include "Piece.h"
@@ -37,6 +38,36 @@ int main()
         return 0;
     }
 
+    if (gameMode == 2)
+    {
+        int engineChoice = 1;
+        cout << "\n";
+        cout << "Choose the AI engine:\n";
+        cout << "1. Quick heuristic (no lookahead)\n";
+        cout << "2. Alpha-beta search\n";
+        cout << "Enter 1 or 2: ";
+        cin >> engineChoice;
+
+        if (engineChoice == 2)
+        {
+            int depth = 0, timeLimitMs = 0;
+            cout << "Search depth in plies (0 for no depth limit): ";
+            cin >> depth;
+            cout << "Time limit per move in milliseconds (0 for no time limit): ";
+            cin >> timeLimitMs;
+            if (depth <= 0 && timeLimitMs <= 0)
+            {
+                depth = 4; // Never search without any limit
+            }
+            int threads = 1;
+            cout << "Search threads (1 to " << max(1u, thread::hardware_concurrency()) << "): ";
+            cin >> threads;
+            aiPlayer.setEngineMode(ALPHA_BETA_ENGINE);
+            aiPlayer.setSearchLimits(SearchLimits(depth, timeLimitMs));
+            aiPlayer.setThreadCount(threads);
+        }
+    }
+
     while (true)
     {
         if (command != "undo" && command != "quit")
@@ -47,21 +78,65 @@ int main()
         cout << "Welcome to Chess (" << (gameMode == 1 ? "Player vs. Player" : "Player vs. AI") << ")!" << endl;
         chessBoard.printBoard();
 
+        // The game ends on mate, stalemate or any of the draw rules
+        GameStatus gameStatus = chessBoard.status();
+        if (gameStatus != ONGOING)
+        {
+            switch (gameStatus)
+            {
+            case CHECKMATE:
+                cout << "Checkmate! Player " << (chessBoard.getSideToMove() == WHITE ? 2 : 1) << " wins!" << endl;
+                break;
+            case STALEMATE:
+                cout << "Stalemate! The game is a draw." << endl;
+                break;
+            case DRAW_FIFTY_MOVES:
+                cout << "Draw by the fifty-move rule." << endl;
+                break;
+            case DRAW_REPETITION:
+                cout << "Draw by threefold repetition." << endl;
+                break;
+            default:
+                cout << "Draw by insufficient material." << endl;
+                break;
+            }
+            break;
+        }
+
         if (chessBoard.isKingInCheck(currentPlayer == 1))
         {
             cout << "Player " << currentPlayer << "'s king is in check!" << endl;
         }
 
-        // Reset attack flags at the start of each turn
-        chessBoard.resetAttackFlags();
         // Player's turn
         if (gameMode == 2 && currentPlayer == 2) // AI's turn if mode is Player vs AI and currentPlayer is 2
         {
             // Call AI's move
-            pair<pair<int, int>, pair<int, int>> aiMove = aiPlayer.selectMove(chessBoard);
-            auto [start, end] = aiMove;
-            cout << "AI moves: " << start.first << "," << start.second << " -> " << end.first << "," << end.second << endl;
-            chessBoard.movePiece(start.first, start.second, end.first, end.second);
+            Move aiMove = aiPlayer.selectMove(chessBoard);
+            cout << "AI moves: " << aiMove.startX() << "," << aiMove.startY() << " -> " << aiMove.endX() << "," << aiMove.endY() << endl;
+
+            const AIStats &stats = aiPlayer.getLastStats();
+            if (aiPlayer.getEngineMode() == ALPHA_BETA_ENGINE)
+            {
+                const SearchResult &result = aiPlayer.getLastSearchResult();
+                cout << "Search: depth " << result.depth << ", score " << result.score << ", "
+                     << result.qnodes << " quiescence nodes, " << result.failHighFirstRate()
+                     << "% of cutoffs on the first move, PV:";
+                for (int i = 0; i < result.pvLength; ++i)
+                {
+                    const Move &move = result.pv[i];
+                    cout << " " << chessBoard.convertToPosition(move.startY(), move.startX())
+                         << chessBoard.convertToPosition(move.endY(), move.endX());
+                }
+                cout << endl;
+
+                TTStats hashStats = aiPlayer.getHashStats();
+                cout << "Hash table: " << hashStats.hits << " hits, " << hashStats.misses << " misses ("
+                     << hashStats.hitRate() << "% hit rate), " << hashStats.collisions << " collisions" << endl;
+            }
+            cout << "AI looked at " << stats.nodes << " nodes in " << stats.elapsedMs << " ms ("
+                 << (uint64_t)stats.nodesPerSecond() << " nodes/s)" << endl;
+            chessBoard.playMove(aiMove); // The engine's own promotion piece, no prompt
 
             currentPlayer = 1; // Switch back to Player 1 after AI's move
             continue;          // Skip player input when AI plays
@@ -126,16 +201,16 @@ int main()
                 continue;
             }
 
-            shared_ptr<Piece> piece = chessBoard.getPiece(startX, startY);
+            PieceCode piece = chessBoard.pieceAt(toSquare(startX, startY));
 
-            if (piece == nullptr)
+            if (piece == NO_PIECE)
             {
                 cout << "No piece at the starting position!" << endl;
                 continue;
             }
 
-            if ((currentPlayer == 1 && piece->isBlack()) ||
-                (currentPlayer == 2 && !piece->isBlack()))
+            if ((currentPlayer == 1 && pieceColor(piece) == BLACK) ||
+                (currentPlayer == 2 && pieceColor(piece) == WHITE))
             {
                 cout << "It's Player " << currentPlayer << "'s turn, but you can't move the opponent's piece!" << endl;
                 continue;
@@ -0,0 +1,97 @@
+#ifndef MOVE_H
+#define MOVE_H
+
+#include <cstdint>
+#include "Bitboard.h"
+
+// Special move kinds, so a move can be replayed without asking the board (4 bits)
+enum MoveFlag
+{
+    NORMAL_MOVE = 0,
+    DOUBLE_PAWN_PUSH,
+    EN_PASSANT,
+    CASTLING,
+    PROMOTE_KNIGHT,
+    PROMOTE_BISHOP,
+    PROMOTE_ROOK,
+    PROMOTE_QUEEN
+};
+
+// A move packed into 16 bits: from square in bits 0-5, to square in bits 6-11 and the
+// MoveFlag in bits 12-15. Move buffers, undo records, hash entries and the AI's move
+// lists all hold it as is, and comparing or hashing a move is one integer operation.
+struct Move
+{
+    uint16_t data;
+
+    constexpr Move() : data(0) {}
+    constexpr Move(int from, int to, int flag = NORMAL_MOVE) : data(uint16_t(from | to << 6 | flag << 12)) {}
+
+    // From (row, column) coordinates, as the console and the Piece interface use them
+    static constexpr Move fromCoordinates(int startX, int startY, int endX, int endY, int flag = NORMAL_MOVE)
+    {
+        return Move(toSquare(startX, startY), toSquare(endX, endY), flag);
+    }
+    static constexpr Move fromRaw(uint16_t data)
+    {
+        Move move;
+        move.data = data;
+        return move;
+    }
+
+    constexpr bool operator==(const Move &other) const { return data == other.data; }
+    constexpr bool operator!=(const Move &other) const { return data != other.data; }
+
+    constexpr uint16_t raw() const { return data; }
+    constexpr int from() const { return data & 63; }
+    constexpr int to() const { return (data >> 6) & 63; }
+    constexpr int flag() const { return data >> 12; } // One of MoveFlag
+    constexpr int startX() const { return squareRow(from()); }
+    constexpr int startY() const { return squareCol(from()); }
+    constexpr int endX() const { return squareRow(to()); }
+    constexpr int endY() const { return squareCol(to()); }
+    constexpr bool isPromotion() const { return flag() >= PROMOTE_KNIGHT; }
+    // Piece the pawn turns into (only meaningful for promotions)
+    constexpr PieceType promotionType() const { return PieceType(KNIGHT + flag() - PROMOTE_KNIGHT); }
+};
+
+// "No move". It reads as a8-a8, which no real move can be.
+constexpr Move MOVE_NONE = Move();
+
+// Move generation stages. CAPTURES also takes the queen promotions and QUIETS the
+// underpromotions, so the two together give NON_EVASIONS. EVASIONS is for a side in
+// check: king moves plus the moves that capture or block a single checker.
+enum GenType
+{
+    CAPTURES,
+    QUIETS,
+    EVASIONS,
+    NON_EVASIONS
+};
+
+// Upper bound on the number of moves in any legal chess position (218)
+const int MAX_MOVES = 256;
+
+// Fixed-capacity move list filled by the move generator.
+// It lives on the caller's stack, so generating moves never touches the heap.
+struct MoveBuffer
+{
+    Move moves[MAX_MOVES];
+    int count;
+
+    MoveBuffer() : count(0) {}
+
+    void clear() { count = 0; }
+    int size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    void add(int from, int to, int flag = NORMAL_MOVE)
+    {
+        moves[count++] = Move(from, to, flag);
+    }
+
+    Move &operator[](int i) { return moves[i]; }
+    const Move &operator[](int i) const { return moves[i]; }
+};
+
+#endif // MOVE_H
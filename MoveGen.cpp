@@ -0,0 +1,454 @@
+#include "Board.h"
+#include <cstdlib>
+
+// Side-wide move generation on top of the bitboards.
+// Moves are appended to a caller-owned MoveBuffer, so nothing here allocates.
+
+namespace
+{
+    // Adds the promotions that belong to the stage: the queen promotion counts as a
+    // capture-like move, the underpromotions as quiet ones (evasions take all four)
+    template <GenType Type>
+    inline void addPromotions(MoveBuffer &moves, int from, int to)
+    {
+        if (Type != QUIETS)
+            moves.add(from, to, PROMOTE_QUEEN);
+        if (Type != CAPTURES)
+        {
+            moves.add(from, to, PROMOTE_ROOK);
+            moves.add(from, to, PROMOTE_BISHOP);
+            moves.add(from, to, PROMOTE_KNIGHT);
+        }
+    }
+
+    // Adds a move for every target square, all starting from the same square
+    inline void addMoves(MoveBuffer &moves, int from, Bitboard targets)
+    {
+        while (targets)
+        {
+            moves.add(from, popLsb(targets));
+        }
+    }
+
+    // En passant is the one move that removes two pieces from a line through the king
+    // (e.g. both pawns on the king's row), so it is checked on the resulting occupancy
+    template <Color Us>
+    bool isLegalEnPassant(const Board &board, int from, int epSquare)
+    {
+        constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+        constexpr int Forward = Us == WHITE ? -8 : 8;
+        Bitboard captured = squareBB(epSquare - Forward);
+        Bitboard occ = (board.occupied() ^ squareBB(from) ^ captured) | squareBB(epSquare);
+        return !(board.attackersTo(board.kingSquare(Us), occ) & board.pieces(Them) & ~captured);
+    }
+
+    // Pawn moves of the given pawns, landing only on allowed squares (the check mask
+    // when evading, the pin line for a pinned pawn, otherwise everything).
+    // Direction, promotion row and double-push row are all fixed by Us.
+    template <Color Us, GenType Type, bool Legal>
+    void generatePawnMoves(const Board &board, MoveBuffer &moves, Bitboard pawns, Bitboard allowed)
+    {
+        constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+        constexpr int Forward = Us == WHITE ? -8 : 8;
+        constexpr Bitboard PromotionRow = Us == WHITE ? rowBB(0) : rowBB(7);
+        constexpr Bitboard DoublePushRow = Us == WHITE ? rowBB(5) : rowBB(2); // Row reached by the first step
+
+        Bitboard empty = ~board.occupied();
+        Bitboard victims = board.pieces(Them) & allowed;
+
+        // Pushes: the plain ones are quiet, the queen promotions go with the captures
+        Bitboard singlePushes = pawnPush<Us>(pawns) & empty;
+        if (Type != CAPTURES)
+        {
+            Bitboard doublePushes = pawnPush<Us>(singlePushes & DoublePushRow) & empty & allowed;
+            for (Bitboard b = singlePushes & allowed & ~PromotionRow; b;)
+            {
+                int to = popLsb(b);
+                moves.add(to - Forward, to);
+            }
+            while (doublePushes)
+            {
+                int to = popLsb(doublePushes);
+                moves.add(to - 2 * Forward, to, DOUBLE_PAWN_PUSH);
+            }
+        }
+        for (Bitboard b = singlePushes & allowed & PromotionRow; b;)
+        {
+            int to = popLsb(b);
+            addPromotions<Type>(moves, to - Forward, to);
+        }
+
+        if (Type == QUIETS)
+        {
+            // Capture-promotions still have their underpromotions to add
+            for (Bitboard b = pawns & pawnAttacksBB<Them>(victims & PromotionRow); b;)
+            {
+                int from = popLsb(b);
+                for (Bitboard captures = pawnAttacks(Us, from) & victims & PromotionRow; captures;)
+                    addPromotions<QUIETS>(moves, from, popLsb(captures));
+            }
+            return;
+        }
+
+        for (Bitboard b = pawns & pawnAttacksBB<Them>(victims); b;)
+        {
+            int from = popLsb(b);
+            for (Bitboard captures = pawnAttacks(Us, from) & victims; captures;)
+            {
+                int to = popLsb(captures);
+                if (squareBB(to) & PromotionRow)
+                    addPromotions<Type>(moves, from, to);
+                else
+                    moves.add(from, to);
+            }
+        }
+
+        // En passant; when evading, only if the pawn that just moved is the checker
+        // (the legal generator tests every en-passant capture on the board instead)
+        int epSquare = board.getEnPassantSquare();
+        if (epSquare != NO_SQUARE && (Legal || Type != EVASIONS || (allowed & squareBB(epSquare - Forward))))
+        {
+            for (Bitboard b = pawns & pawnAttacks(Them, epSquare); b;)
+            {
+                int from = popLsb(b);
+                if (!Legal || isLegalEnPassant<Us>(board, from, epSquare))
+                    moves.add(from, epSquare, EN_PASSANT);
+            }
+        }
+    }
+
+    template <Color Us>
+    void generateCastling(const Board &board, MoveBuffer &moves)
+    {
+        // The right must still exist, the squares between king and rook must be
+        // empty and the king may not start on, pass through or land on an attacked square
+        constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+        constexpr int Row = Us == WHITE ? 7 : 0;
+        constexpr int KingStart = toSquare(Row, 4);
+        constexpr int Kingside = Us == WHITE ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+        constexpr int Queenside = Us == WHITE ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+
+        int rights = board.getCastlingRights();
+        if (!(rights & (Kingside | Queenside)) || board.kingSquare(Us) != KingStart ||
+            board.isSquareAttacked(KingStart, Them))
+            return;
+
+        Bitboard occ = board.occupied();
+        Bitboard rooks = board.pieces(Us, ROOK);
+        if ((rights & Kingside) && (rooks & squareBB(toSquare(Row, 7))) && !(betweenBB(KingStart, toSquare(Row, 7)) & occ) &&
+            !board.isSquareAttacked(toSquare(Row, 5), Them) && !board.isSquareAttacked(toSquare(Row, 6), Them))
+        {
+            moves.add(KingStart, toSquare(Row, 6), CASTLING);
+        }
+        if ((rights & Queenside) && (rooks & squareBB(toSquare(Row, 0))) && !(betweenBB(KingStart, toSquare(Row, 0)) & occ) &&
+            !board.isSquareAttacked(toSquare(Row, 3), Them) && !board.isSquareAttacked(toSquare(Row, 2), Them))
+        {
+            moves.add(KingStart, toSquare(Row, 2), CASTLING);
+        }
+    }
+
+    // Moves of one stage for side Us. The pseudo-legal version (Legal = false) may
+    // leave the king in check; the legal one works out the checkers and the pinned
+    // pieces first and only emits moves that are legal as they stand.
+    template <Color Us, GenType Type, bool Legal>
+    void generateAll(const Board &board, MoveBuffer &moves)
+    {
+        constexpr Color Them = Us == WHITE ? BLACK : WHITE;
+        Bitboard occ = board.occupied();
+        Bitboard own = board.pieces(Us);
+        int kingSq = board.kingSquare(Us);
+
+        // Squares the pieces may move to
+        Bitboard targets = Type == CAPTURES ? board.pieces(Them)
+                         : Type == QUIETS   ? ~occ
+                                            : ~own;
+
+        // With two checkers only the king can move; with one, the other pieces
+        // must capture it or step in between
+        Bitboard checkers = 0;
+        Bitboard checkMask = ~0ULL;
+        if ((Legal || Type == EVASIONS) && kingSq != NO_SQUARE)
+        {
+            checkers = board.attackersTo(kingSq, occ) & board.pieces(Them);
+            if (checkers)
+                checkMask = popCount(checkers) > 1 ? 0 : checkers | betweenBB(kingSq, lsb(checkers));
+        }
+
+        // A piece alone between the king and an enemy slider may only move along that line.
+        // Pinned pieces are generated here, one at a time; a pinned knight never moves.
+        Bitboard pinned = 0;
+        if (Legal && kingSq != NO_SQUARE && checkMask)
+        {
+            Bitboard snipers = (rookAttacks(kingSq, 0) & (board.pieces(Them, ROOK) | board.pieces(Them, QUEEN))) |
+                               (bishopAttacks(kingSq, 0) & (board.pieces(Them, BISHOP) | board.pieces(Them, QUEEN)));
+            while (snipers)
+            {
+                int sniper = popLsb(snipers);
+                Bitboard blockers = betweenBB(kingSq, sniper) & occ;
+                if (!blockers || (blockers & (blockers - 1)) || !(blockers & own))
+                    continue;
+
+                pinned |= blockers;
+                int from = lsb(blockers);
+                Bitboard pinLine = (betweenBB(kingSq, sniper) | squareBB(sniper)) & checkMask;
+                switch (board.pieceTypeAt(from))
+                {
+                case PAWN:
+                    generatePawnMoves<Us, Type, Legal>(board, moves, blockers, pinLine);
+                    break;
+                case BISHOP:
+                    addMoves(moves, from, bishopAttacks(from, occ) & targets & pinLine);
+                    break;
+                case ROOK:
+                    addMoves(moves, from, rookAttacks(from, occ) & targets & pinLine);
+                    break;
+                case QUEEN:
+                    addMoves(moves, from, queenAttacks(from, occ) & targets & pinLine);
+                    break;
+                default:
+                    break;
+                }
+            }
+        }
+
+        Bitboard pieceTargets = targets & checkMask;
+        if (checkMask)
+        {
+            generatePawnMoves<Us, Type, Legal>(board, moves, board.pieces(Us, PAWN) & ~pinned, checkMask);
+            for (Bitboard b = board.pieces(Us, KNIGHT) & ~pinned; b;)
+            {
+                int from = popLsb(b);
+                addMoves(moves, from, knightAttacks(from) & pieceTargets);
+            }
+            for (Bitboard b = (board.pieces(Us, BISHOP) | board.pieces(Us, QUEEN)) & ~pinned; b;)
+            {
+                int from = popLsb(b);
+                addMoves(moves, from, bishopAttacks(from, occ) & pieceTargets);
+            }
+            for (Bitboard b = (board.pieces(Us, ROOK) | board.pieces(Us, QUEEN)) & ~pinned; b;)
+            {
+                int from = popLsb(b);
+                addMoves(moves, from, rookAttacks(from, occ) & pieceTargets);
+            }
+        }
+
+        if (kingSq == NO_SQUARE)
+            return;
+        Bitboard kingTargets = kingAttacks(kingSq) & targets;
+        if (Legal || Type == EVASIONS)
+            kingTargets &= ~board.attacks(Them);
+        if (Legal && checkers)
+        {
+            // The attack map was built with the king in place, so it misses the squares
+            // behind the king on a checking line; look at those without the king
+            for (Bitboard b = kingTargets; b;)
+            {
+                int to = popLsb(b);
+                if (!(board.attackersTo(to, occ ^ squareBB(kingSq)) & board.pieces(Them)))
+                    moves.add(kingSq, to);
+            }
+        }
+        else
+        {
+            addMoves(moves, kingSq, kingTargets);
+        }
+        if (Type == QUIETS || Type == NON_EVASIONS)
+            generateCastling<Us>(board, moves);
+    }
+
+    template <GenType Type, bool Legal>
+    inline void generateFor(const Board &board, Color side, MoveBuffer &moves)
+    {
+        if (side == WHITE)
+            generateAll<WHITE, Type, Legal>(board, moves);
+        else
+            generateAll<BLACK, Type, Legal>(board, moves);
+    }
+
+    template <bool Legal>
+    void generateStage(const Board &board, GenType type, MoveBuffer &moves)
+    {
+        Color side = board.getSideToMove();
+        switch (type)
+        {
+        case CAPTURES:
+            generateFor<CAPTURES, Legal>(board, side, moves);
+            break;
+        case QUIETS:
+            generateFor<QUIETS, Legal>(board, side, moves);
+            break;
+        case EVASIONS:
+            generateFor<EVASIONS, Legal>(board, side, moves);
+            break;
+        case NON_EVASIONS:
+            generateFor<NON_EVASIONS, Legal>(board, side, moves);
+            break;
+        }
+    }
+}
+
+void Board::generateMoves(Color side, MoveBuffer &moves) const
+{
+    generateFor<NON_EVASIONS, false>(*this, side, moves);
+}
+
+void Board::generateMoves(GenType type, MoveBuffer &moves) const
+{
+    generateStage<false>(*this, type, moves);
+}
+
+void Board::generateLegalMoves(GenType type, MoveBuffer &moves) const
+{
+    generateStage<true>(*this, type, moves);
+}
+
+bool Board::isPseudoLegal(const Move &move) const
+{
+    int from = move.from();
+    int to = move.to();
+    PieceCode piece = pos.mailbox[from];
+    // Moves from elsewhere may carry any 4-bit flag; only the defined ones can be played
+    if (move == MOVE_NONE || move.flag() > PROMOTE_QUEEN || piece == NO_PIECE || pieceColor(piece) != pos.sideToMove)
+        return false;
+
+    // Castling is rare enough here to simply look for it among the generated moves
+    if (move.flag() == CASTLING)
+    {
+        MoveBuffer moves;
+        generateMoves(QUIETS, moves);
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            if (moves[i] == move)
+                return true;
+        }
+        return false;
+    }
+
+    // Otherwise the move has to reach its target and carry the flag the generator gives it
+    if (!(pieceTargets(piece, from, *this) & squareBB(to)))
+        return false;
+    int flag = NORMAL_MOVE;
+    if (typeOf(piece) == PAWN)
+    {
+        if (to == pos.enPassantSquare && squareCol(from) != squareCol(to))
+            flag = EN_PASSANT;
+        else if (abs(squareRow(from) - squareRow(to)) == 2)
+            flag = DOUBLE_PAWN_PUSH;
+        else if (squareRow(to) == 0 || squareRow(to) == 7)
+            return move.flag() >= PROMOTE_KNIGHT && move.flag() <= PROMOTE_QUEEN;
+    }
+    return move.flag() == flag;
+}
+
+bool Board::isLegalMove(const Move &move) const
+{
+    int from = move.from();
+    int to = move.to();
+    Color side = colorAt(from);
+    Color them = opposite(side);
+
+    // Castling moves are fully checked while generating them
+    if (move.flag() == CASTLING)
+        return true;
+
+    int ownKingSq = pos.kingSq[side];
+    if (ownKingSq == NO_SQUARE)
+        return true;
+
+    // Out of check, the attack map answers most moves at once: the king may go to any
+    // square the enemy does not attack, and a piece that is not on a line from the king
+    // cannot be pinned
+    if (!isSquareAttacked(ownKingSq, them))
+    {
+        if (from == ownKingSq)
+            return !(attacks(them) & squareBB(to));
+        if (move.flag() != EN_PASSANT && !(queenRays(ownKingSq) & squareBB(from)))
+            return true;
+    }
+
+    // Play the move on a copy of the occupancy only, then look for attackers of our king
+    Bitboard captured = squareBB(to);
+    if (move.flag() == EN_PASSANT)
+        captured = squareBB(toSquare(move.startX(), move.endY()));
+    Bitboard occ = (occupied() & ~squareBB(from) & ~captured) | squareBB(to);
+    int kingAfter = from == ownKingSq ? to : ownKingSq;
+
+    return (attackersTo(kingAfter, occ) & pieces(them) & ~captured) == 0;
+}
+
+void Board::generateLegalMoves(Color side, MoveBuffer &moves) const
+{
+    if (pos.kingSq[side] != NO_SQUARE && isSquareAttacked(pos.kingSq[side], opposite(side)))
+        generateFor<EVASIONS, true>(*this, side, moves);
+    else
+        generateFor<NON_EVASIONS, true>(*this, side, moves);
+}
+
+bool Board::hasLegalMove() const
+{
+    Color us = pos.sideToMove;
+    Color them = opposite(us);
+    int king = pos.kingSq[us];
+    Bitboard occ = occupied();
+    Bitboard own = pieces(us);
+    bool checked = king != NO_SQUARE && isSquareAttacked(king, them);
+    if (king != NO_SQUARE)
+    {
+        // A king move needs no generation at all; in check, look past the king as
+        // the legal generator does
+        for (Bitboard b = kingAttacks(king) & ~own & ~attacks(them); b;)
+        {
+            int to = popLsb(b);
+            if (!checked || !(attackersTo(to, occ ^ squareBB(king)) & pieces(them)))
+                return true;
+        }
+    }
+
+    // In check only the evasions count, and there are few of them
+    if (checked)
+    {
+        MoveBuffer moves;
+        generateLegalMoves(EVASIONS, moves);
+        return !moves.empty();
+    }
+
+    // Out of check every move of a piece that is not pinned is legal (en passant aside),
+    // so the first such piece with somewhere to go settles it
+    Bitboard pinned = 0;
+    if (king != NO_SQUARE)
+    {
+        Bitboard snipers = (rookAttacks(king, 0) & (pieces(them, ROOK) | pieces(them, QUEEN))) |
+                           (bishopAttacks(king, 0) & (pieces(them, BISHOP) | pieces(them, QUEEN)));
+        while (snipers)
+        {
+            Bitboard blockers = betweenBB(king, popLsb(snipers)) & occ;
+            if (blockers && !(blockers & (blockers - 1)) && (blockers & own))
+                pinned |= blockers;
+        }
+    }
+    for (Bitboard b = pieces(us, KNIGHT) & ~pinned; b;)
+    {
+        if (knightAttacks(popLsb(b)) & ~own)
+            return true;
+    }
+    for (Bitboard b = (pieces(us, BISHOP) | pieces(us, QUEEN)) & ~pinned; b;)
+    {
+        if (bishopAttacks(popLsb(b), occ) & ~own)
+            return true;
+    }
+    for (Bitboard b = (pieces(us, ROOK) | pieces(us, QUEEN)) & ~pinned; b;)
+    {
+        if (rookAttacks(popLsb(b), occ) & ~own)
+            return true;
+    }
+    Bitboard pawns = pieces(us, PAWN) & ~pinned;
+    Bitboard pushes = us == WHITE ? pawnPush<WHITE>(pawns) : pawnPush<BLACK>(pawns);
+    if ((pushes & ~occ) || (pawnAttacksBB(us, pawns) & pieces(them)))
+        return true;
+
+    // Only pinned pieces or en passant can still move, if anything: rare enough to
+    // generate in full
+    MoveBuffer moves;
+    generateLegalMoves(us, moves);
+    return !moves.empty();
+}
@@ -0,0 +1,179 @@
+#include "MovePicker.h"
+#include "Board.h"
+#include "See.h"
+
+namespace
+{
+    // Victim ranks for MVV-LVA, indexed by PieceType (NO_PIECE_TYPE for a quiet promotion)
+    const int VICTIM_RANK[7] = {1, 2, 3, 4, 5, 0, 0};
+
+    // Most valuable victim first, then least valuable attacker; a queen promotion
+    // counts as winning a queen
+    int mvvLva(const Board &board, Move move)
+    {
+        PieceType victim = move.flag() == EN_PASSANT ? PAWN : board.pieceTypeAt(move.to());
+        int score = VICTIM_RANK[victim] * 8 - board.pieceTypeAt(move.from());
+        if (move.flag() == PROMOTE_QUEEN)
+            score += VICTIM_RANK[QUEEN] * 8;
+        return score;
+    }
+}
+
+MovePicker::MovePicker(const Board &board, Move hashMove, const Move *killers, Move counterMove,
+                       const QuietHistory *history)
+    : board(board), history(history), hashMove(hashMove), stage(HASH_STAGE), refutationIndex(0), current(0),
+      badCaptures(0), capturesOnly(false)
+{
+    for (int i = 0; i < KILLER_SLOTS; ++i)
+        refutations[i] = killers ? killers[i] : MOVE_NONE;
+    // A countermove that is also a killer is handed out once
+    bool isKiller = counterMove == refutations[0] || counterMove == refutations[1];
+    refutations[KILLER_SLOTS] = isKiller ? MOVE_NONE : counterMove;
+}
+
+MovePicker::MovePicker(const Board &board)
+    : board(board), history(nullptr), hashMove(MOVE_NONE), stage(GENERATE_CAPTURES), refutationIndex(0), current(0),
+      badCaptures(0), capturesOnly(true)
+{
+    for (Move &move : refutations)
+        move = MOVE_NONE;
+}
+
+bool MovePicker::inCaptureStage(Move move) const
+{
+    if (move.isPromotion())
+        return move.flag() == PROMOTE_QUEEN;
+    return move.flag() == EN_PASSANT || board.pieceAt(move.to()) != NO_PIECE;
+}
+
+bool MovePicker::alreadyTried(Move move) const
+{
+    if (move == hashMove)
+        return true;
+    for (int i = 0; i < refutationIndex; ++i)
+    {
+        if (move == refutations[i])
+            return true;
+    }
+    return false;
+}
+
+void MovePicker::scoreCaptures()
+{
+    for (int i = 0; i < moves.size(); ++i)
+        scores[i] = mvvLva(board, moves[i]);
+}
+
+Move MovePicker::pickBest()
+{
+    int best = current;
+    for (int i = current + 1; i < moves.size(); ++i)
+    {
+        if (scores[i] > scores[best])
+            best = i;
+    }
+    Move move = moves[best];
+    moves[best] = moves[current];
+    scores[best] = scores[current];
+    ++current;
+    return move;
+}
+
+Move MovePicker::next()
+{
+    while (true)
+    {
+        switch (stage)
+        {
+        case HASH_STAGE:
+            stage = board.inCheck() ? GENERATE_EVASIONS : GENERATE_CAPTURES;
+            if (hashMove != MOVE_NONE && board.isPseudoLegal(hashMove) && board.isLegalMove(hashMove))
+                return hashMove;
+            hashMove = MOVE_NONE; // Unusable here, so nothing later has to skip it
+            break;
+
+        case GENERATE_CAPTURES:
+            board.generateLegalMoves(CAPTURES, moves);
+            scoreCaptures();
+            stage = CAPTURE_STAGE;
+            break;
+
+        case CAPTURE_STAGE:
+            while (current < moves.size())
+            {
+                Move move = pickBest();
+                if (move == hashMove)
+                    continue;
+                // Losing captures wait until after the quiets. Every slot before current
+                // has been handed out already, so they can be kept there.
+                if (!seeLoses(board, move))
+                    return move;
+                if (!capturesOnly)
+                    moves[badCaptures++] = move;
+            }
+            stage = capturesOnly ? DONE : KILLER_STAGE;
+            break;
+
+        case KILLER_STAGE:
+            // Killers and countermoves come from other positions, so they have to be checked
+            // here. One that is now a capture was already handed out by the capture stage.
+            while (refutationIndex < KILLER_SLOTS + 1)
+            {
+                Move move = refutations[refutationIndex++];
+                if (move != MOVE_NONE && move != hashMove && !inCaptureStage(move) &&
+                    board.isPseudoLegal(move) && board.isLegalMove(move))
+                    return move;
+            }
+            stage = GENERATE_QUIETS;
+            break;
+
+        case GENERATE_QUIETS:
+            // Appended after the losing captures
+            moves.count = badCaptures;
+            current = badCaptures;
+            board.generateLegalMoves(QUIETS, moves);
+            for (int i = current; i < moves.size(); ++i)
+                scores[i] = history ? history->score(board.getSideToMove(), moves[i]) : 0;
+            stage = QUIET_STAGE;
+            break;
+
+        case QUIET_STAGE:
+            while (current < moves.size())
+            {
+                Move move = history ? pickBest() : moves[current++];
+                if (!alreadyTried(move))
+                    return move;
+            }
+            current = 0;
+            stage = BAD_CAPTURE_STAGE;
+            break;
+
+        case BAD_CAPTURE_STAGE:
+            if (current < badCaptures)
+                return moves[current++];
+            stage = DONE;
+            break;
+
+        case GENERATE_EVASIONS:
+            // Few moves, all at once: captures of the checker first, then the rest
+            board.generateLegalMoves(EVASIONS, moves);
+            for (int i = 0; i < moves.size(); ++i)
+                scores[i] = inCaptureStage(moves[i]) ? 1000 + mvvLva(board, moves[i]) : 0;
+            stage = EVASION_STAGE;
+            break;
+
+        case EVASION_STAGE:
+            while (current < moves.size())
+            {
+                Move move = pickBest();
+                if (move != hashMove)
+                    return move;
+            }
+            stage = DONE;
+            break;
+
+        default:
+            return MOVE_NONE;
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#ifndef MOVE_PICKER_H
+#define MOVE_PICKER_H
+
+#include "Move.h"
+
+class Board;
+
+// What the search has learnt about quiet moves, for ordering them. Each search thread
+// keeps its own, so nothing here is shared.
+struct QuietHistory
+{
+    // Scores stay below MAX_SCORE: an update moves an entry part of the way towards the
+    // bound ("gravity"), so old results fade instead of saturating the table
+    static const int MAX_SCORE = 16384;
+
+    int butterfly[2][64][64];             // Cutoff history, indexed by [Color][from][to]
+    Move counterMoves[PIECE_CODE_NB][64]; // Quiet reply that refuted a move, by [piece moved][its target]
+
+    QuietHistory() { clear(); }
+
+    void clear()
+    {
+        for (auto &side : butterfly)
+            for (auto &from : side)
+                for (int &score : from)
+                    score = 0;
+        for (auto &piece : counterMoves)
+            for (Move &move : piece)
+                move = MOVE_NONE;
+    }
+
+    // Between searches: keep the ordering, but let the new search outweigh the old ones
+    void age()
+    {
+        for (auto &side : butterfly)
+            for (auto &from : side)
+                for (int &score : from)
+                    score /= 2;
+    }
+
+    int score(Color side, Move move) const { return butterfly[side][move.from()][move.to()]; }
+
+    // Rewards a quiet move that caused a cutoff. Penalising the quiets tried before it
+    // as well cost nodes in the bench, so only cutoffs are recorded.
+    void update(Color side, Move move, int bonus)
+    {
+        int &entry = butterfly[side][move.from()][move.to()];
+        entry += bonus - entry * bonus / MAX_SCORE;
+    }
+};
+
+// Hands out the legal moves of a position one at a time, best guesses first:
+//   1. the hash move (best move stored for this position)
+//   2. captures and queen promotions, most valuable victim / least valuable attacker first,
+//      except those that lose material by static exchange evaluation (see See.h)
+//   3. the killer moves (quiet moves that caused a cutoff at the same ply elsewhere),
+//      then the countermove (the quiet move that last refuted the opponent's last move)
+//   4. the remaining quiet moves, by butterfly history
+//   5. the losing captures
+// Each stage is generated only when the previous one runs out, so a cutoff on the hash
+// move or a capture never pays for generating the quiets. In check all evasions are
+// generated at once and ordered the same way.
+class MovePicker
+{
+public:
+    // killers may be null; otherwise it points to KILLER_SLOTS moves (MOVE_NONE for empty slots).
+    // Without a history the quiets come in generation order.
+    static const int KILLER_SLOTS = 2;
+
+    MovePicker(const Board &board, Move hashMove, const Move *killers = nullptr, Move counterMove = MOVE_NONE,
+               const QuietHistory *history = nullptr);
+    // For quiescence search: only the captures and queen promotions that do not lose
+    // material, best first. Out of check only.
+    explicit MovePicker(const Board &board);
+
+    // The next move to try, or MOVE_NONE when every legal move has been handed out
+    Move next();
+
+private:
+    enum Stage
+    {
+        HASH_STAGE,
+        GENERATE_CAPTURES,
+        CAPTURE_STAGE,
+        KILLER_STAGE,
+        GENERATE_QUIETS,
+        QUIET_STAGE,
+        BAD_CAPTURE_STAGE,
+        GENERATE_EVASIONS,
+        EVASION_STAGE,
+        DONE
+    };
+
+    void scoreCaptures();
+    Move pickBest();                      // Removes and returns the best scored move left in the buffer
+    bool inCaptureStage(Move move) const; // Whether the capture stage generates this move
+    bool alreadyTried(Move move) const;   // Handed out by the hash or killer stage
+
+    const Board &board;
+    const QuietHistory *history;
+    Move hashMove;
+    Move refutations[KILLER_SLOTS + 1]; // The killers, then the countermove
+    int stage;
+    int refutationIndex;
+    MoveBuffer moves;
+    int scores[MAX_MOVES];
+    int current;
+    int badCaptures; // Losing captures set aside at the front of moves, count
+    bool capturesOnly;
+};
+
+#endif // MOVE_PICKER_H
@@ -0,0 +1,72 @@
+#include "ParallelSearch.h"
+#include <thread>
+#include "Board.h"
+
+using namespace std;
+
+ParallelSearch::Helper::Helper(TranspositionTable &tt, int threadId, const atomic<bool> *stopSignal)
+    : board(new Board()), search(tt, threadId, stopSignal) {}
+
+ParallelSearch::Helper::~Helper() {}
+
+ParallelSearch::ParallelSearch(TranspositionTable &tt)
+    : tt(&tt), stopSignal(false), mainSearch(tt, 0, &stopSignal) {}
+
+ParallelSearch::~ParallelSearch() {}
+
+void ParallelSearch::setThreadCount(int threads)
+{
+    threads = max(threads, 1);
+    while (getThreadCount() > threads)
+        helpers.pop_back();
+    while (getThreadCount() < threads)
+        helpers.emplace_back(new Helper(*tt, getThreadCount(), &stopSignal));
+}
+
+SearchResult ParallelSearch::run(Board &board, const SearchLimits &limits)
+{
+    tt->newSearch();
+    stopSignal = false;
+
+    vector<thread> threads;
+    for (unique_ptr<Helper> &helper : helpers)
+    {
+        helper->board->setPosition(board.position());
+        Helper *h = helper.get();
+        threads.emplace_back([h, &limits]() { h->result = h->search.run(*h->board, limits); });
+    }
+
+    // The main thread decides when the search is over: the helpers stop with it
+    SearchResult result = mainSearch.run(board, limits);
+    stopSignal = true;
+    for (thread &t : threads)
+        t.join();
+
+    // A helper that completed a deeper iteration than the main thread has the better move
+    uint64_t nodes = result.nodes;
+    uint64_t qnodes = result.qnodes;
+    uint64_t failHighs = result.failHighs, failHighsFirst = result.failHighsFirst;
+    TTStats hashStats = result.hashStats;
+    for (unique_ptr<Helper> &helper : helpers)
+    {
+        nodes += helper->result.nodes;
+        qnodes += helper->result.qnodes;
+        failHighs += helper->result.failHighs;
+        failHighsFirst += helper->result.failHighsFirst;
+        hashStats.hits += helper->result.hashStats.hits;
+        hashStats.misses += helper->result.hashStats.misses;
+        hashStats.collisions += helper->result.hashStats.collisions;
+        if (helper->result.hasMove && helper->result.depth > result.depth)
+        {
+            double elapsedMs = result.elapsedMs;
+            result = helper->result;
+            result.elapsedMs = elapsedMs;
+        }
+    }
+    result.nodes = nodes;
+    result.qnodes = qnodes;
+    result.failHighs = failHighs;
+    result.failHighsFirst = failHighsFirst;
+    result.hashStats = hashStats;
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef PARALLEL_SEARCH_H
+#define PARALLEL_SEARCH_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include "Search.h"
+
+class Board;
+
+// Lazy SMP: every thread runs its own iterative-deepening search of the same root,
+// and they only cooperate through the shared transposition table. Helper threads
+// skip some depths (Search::skipsDepth), so they fill the table with results the main
+// thread is about to need. The main thread searches the caller's board; each helper
+// owns a board of its own.
+class ParallelSearch
+{
+public:
+    explicit ParallelSearch(TranspositionTable &tt);
+    ~ParallelSearch();
+
+    // Number of threads including the caller's. Helper boards are created here, so
+    // call it from the thread that plays the game, not during a search.
+    void setThreadCount(int threads);
+    int getThreadCount() const { return int(helpers.size()) + 1; }
+
+    // Starts a new search on the table, searches with all threads and returns the
+    // result of the deepest completed iteration. The counters (nodes, cutoffs, hash
+    // table hits and misses) add up all threads.
+    SearchResult run(Board &board, const SearchLimits &limits);
+
+private:
+    // A helper's board and search stack, on cache lines of their own
+    struct alignas(64) Helper
+    {
+        std::unique_ptr<Board> board;
+        Search search;
+        SearchResult result;
+
+        Helper(TranspositionTable &tt, int threadId, const std::atomic<bool> *stopSignal);
+        ~Helper();
+    };
+
+    TranspositionTable *tt;
+    std::atomic<bool> stopSignal;
+    Search mainSearch;
+    std::vector<std::unique_ptr<Helper>> helpers;
+};
+
+#endif // PARALLEL_SEARCH_H
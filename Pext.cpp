@@ -0,0 +1,115 @@
+#include <utility>
+#include "Bitboard.h"
+#include "SliderGen.h"
+#if SLIDER_PEXT_AVAILABLE && !defined(_MSC_VER)
+#include <cpuid.h>
+#endif
+
+// PEXT tables for rookAttacks()/bishopAttacks(), and the choice of backend.
+//
+// Like the magic tables, the attack tables are built by constexpr code when this file
+// is compiled. Entry i of a square's table holds the attacks for the blocker set whose
+// pext() over the mask is i.
+
+using namespace SliderGen;
+
+namespace
+{
+    // One square's table, a constant of its own to keep each compile-time evaluation small
+    template <int SQ, bool ROOK>
+    struct PextTable
+    {
+        static constexpr const int *DX = ROOK ? ROOK_DX : BISHOP_DX;
+        static constexpr const int *DY = ROOK ? ROOK_DY : BISHOP_DY;
+        static constexpr Bitboard MASK = relevanceMask(SQ, DX, DY);
+        static constexpr unsigned SIZE = 1u << countBits(MASK);
+
+        struct Attacks
+        {
+            Bitboard entries[SIZE];
+        };
+
+        static constexpr Attacks build()
+        {
+            Attacks table{};
+            for (unsigned i = 0; i < SIZE; ++i)
+                table.entries[i] = slidingAttacks(SQ, depositBits(i, MASK), DX, DY);
+            return table;
+        }
+
+        static constexpr Attacks ATTACKS = build();
+
+        static constexpr SliderPext entry() { return SliderPext{MASK, ATTACKS.entries}; }
+    };
+
+    template <int... SQS>
+    constexpr PextTables buildPextTables(std::integer_sequence<int, SQS...>)
+    {
+        return PextTables{{PextTable<SQS, true>::entry()...}, {PextTable<SQS, false>::entry()...}};
+    }
+
+    // BMI2 support from CPUID leaf 7, and whether PEXT is actually fast: AMD CPUs before
+    // Zen 3 (family 19h) implement it in microcode, far slower than a magic multiply
+    bool detectFastPext()
+    {
+#if SLIDER_PEXT_AVAILABLE
+        unsigned regs[4] = {0, 0, 0, 0}; // eax, ebx, ecx, edx
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        regs[1] = info[1], regs[2] = info[2], regs[3] = info[3];
+#else
+        if (__get_cpuid_max(0, nullptr) < 7)
+            return false;
+        __cpuid(0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+        // Vendor string is in ebx, edx, ecx: "Auth" "enti" "cAMD"
+        bool isAmd = regs[1] == 0x68747541 && regs[3] == 0x69746E65 && regs[2] == 0x444D4163;
+
+#if defined(_MSC_VER)
+        __cpuidex(info, 7, 0);
+        bool hasBmi2 = (info[1] & (1 << 8)) != 0;
+        __cpuid(info, 1);
+        unsigned signature = unsigned(info[0]);
+#else
+        __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+        bool hasBmi2 = (regs[1] & (1 << 8)) != 0;
+        __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+        unsigned signature = regs[0];
+#endif
+        unsigned family = (signature >> 8) & 0xF;
+        if (family == 0xF)
+            family += (signature >> 20) & 0xFF; // Extended family
+        return hasBmi2 && !(isAmd && family < 0x19);
+#else
+        return false;
+#endif
+    }
+
+    const bool FAST_PEXT = detectFastPext();
+}
+
+extern const PextTables PEXT_TABLES;
+constexpr PextTables PEXT_TABLES = buildPextTables(std::make_integer_sequence<int, 64>());
+
+SliderBackend sliderBackend = FAST_PEXT ? PEXT_BACKEND : MAGIC_BACKEND;
+
+bool cpuHasFastPext()
+{
+    return FAST_PEXT;
+}
+
+bool setSliderBackend(SliderBackend backend)
+{
+    if (backend == PEXT_BACKEND && !FAST_PEXT)
+        return false;
+    sliderBackend = backend;
+    return true;
+}
+
+const char *sliderBackendName(SliderBackend backend)
+{
+    return backend == PEXT_BACKEND ? "pext" : "magic";
+}
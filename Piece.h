@@ -8,19 +8,30 @@
 #include <stack>
 #include "Board.h" // Make sure this is included
 #include "Checkmate.h"
+#include "Bitboard.h"
+#include "Move.h"
 using namespace std;
 
 
 //Give prototype implementation so that we can use all of its features in the Piece class
 class Board;
+
+// Per-type piece behavior on compact piece codes, dispatched with a switch.
+// The board stores PieceCode values; the Piece classes below are only a facade over these.
+bool isValidPieceMove(PieceCode piece, int startX, int startY, int endX, int endY); // Movement shape only
+Bitboard pieceTargets(PieceCode piece, int sq, const Board &board); // Target squares, ignoring checks and castling
+vector<pair<int, int>> pieceMoveList(PieceCode piece, int startX, int startY, const Board &board);
+
 // Base class for all chess pieces
 class Piece
 {
 protected:
     bool isWhite;  // true for white, false for black
     bool hasMoved; // Track if the piece has moved
+    PieceCode pieceCode;
 public:
-    Piece(bool isWhite) : isWhite(isWhite) {}
+    Piece(bool isWhite, PieceType type) : isWhite(isWhite), hasMoved(false), pieceCode(makePiece(colorOf(isWhite), type)) {}
+    PieceCode code() const { return pieceCode; }
     // Determines if the piece belongs to the black player
     bool isBlack() const
     {
@@ -33,33 +44,18 @@ public:
     virtual bool isValidMove(int startX, int startY, int endX, int endY) const = 0; // Pure virtual function for move validation
     // Pure virtual function to get legal moves for a piece
     virtual vector<pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const = 0;
-    // Pure virtual function to mark attacked squares
-    virtual void markAttacks(int x, int y, Board &board) = 0;
     virtual string getType() const = 0;
     bool getColor() const { return isWhite; } // Returns the piece color
 };
 
-struct Move
-{
-    int startX, startY, endX, endY;
-
-    // Constructor to initialize start and end positions
-    Move(int startX, int startY, int endX, int endY)
-        : startX(startX), startY(startY), endX(endX), endY(endY) {}
-
-    // Default constructor (optional)
-    Move() : startX(0), startY(0), endX(0), endY(0) {}
-};
-
 // King class
 class King : public Piece
 {
 public:
-    King(bool isWhite) : Piece(isWhite) {}
+    King(bool isWhite) : Piece(isWhite, KING) {}
     char getSymbol() const override { return isWhite ? 'K' : 'k'; }
     bool isValidMove(int startX, int startY, int endX, int endY) const override;
     vector<pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const override;
-    void markAttacks(int x, int y, Board& board) override;
     string getType() const override { return "King"; }
 };
 
@@ -67,11 +63,10 @@ public:
 class Queen : public Piece
 {
 public:
-    Queen(bool isWhite) : Piece(isWhite) {}
+    Queen(bool isWhite) : Piece(isWhite, QUEEN) {}
     char getSymbol() const override { return isWhite ? 'Q' : 'q'; }
     bool isValidMove(int startX, int startY, int endX, int endY) const override;
     vector<std::pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const override;
-    void markAttacks(int x, int y, Board& board) override;
     string getType() const override { return "Queen"; }
     
 };
@@ -80,11 +75,10 @@ public:
 class Rook : public Piece
 {
 public:
-    Rook(bool isWhite) : Piece(isWhite) {}
+    Rook(bool isWhite) : Piece(isWhite, ROOK) {}
     char getSymbol() const override { return isWhite ? 'R' : 'r'; }
     bool isValidMove(int startX, int startY, int endX, int endY) const override;
     vector<pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const override;
-    void markAttacks(int x, int y, Board& board) override;
     string getType() const override { return "Rook"; }
    
 };
@@ -93,11 +87,10 @@ public:
 class Bishop : public Piece
 {
 public:
-    Bishop(bool isWhite) : Piece(isWhite) {}
+    Bishop(bool isWhite) : Piece(isWhite, BISHOP) {}
     char getSymbol() const override { return isWhite ? 'B' : 'b'; }
     bool isValidMove(int startX, int startY, int endX, int endY) const override;
     vector<pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const override;
-    void markAttacks(int x, int y, Board& board) override;
     string getType() const override { return "Bishop"; }
     
 };
@@ -106,11 +99,10 @@ public:
 class Knight : public Piece
 {
 public:
-    Knight(bool isWhite) : Piece(isWhite) {}
+    Knight(bool isWhite) : Piece(isWhite, KNIGHT) {}
     char getSymbol() const override { return isWhite ? 'N' : 'n'; }
     bool isValidMove(int startX, int startY, int endX, int endY) const override;
     vector<std::pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const override;
-    void markAttacks(int x, int y, Board& board) override;
     string getType() const override { return "Knight"; }
     
 };
@@ -119,11 +111,10 @@ public:
 class Pawn : public Piece
 {
 public:
-    Pawn(bool isWhite) : Piece(isWhite) {}
+    Pawn(bool isWhite) : Piece(isWhite, PAWN) {}
     char getSymbol() const override { return isWhite ? 'P' : 'p'; }
     bool isValidMove(int startX, int startY, int endX, int endY) const override;
     vector<pair<int, int>> getLegalMoves(int startX, int startY, const Board &board) const override;
-    void markAttacks(int x, int y, Board &board) override;
     string getType() const override { return "Pawn"; }
     
 };
@@ -0,0 +1,32 @@
+#ifndef POSITION_H
+#define POSITION_H
+
+#include <cstdint>
+#include <type_traits>
+#include "Bitboard.h"
+
+// Everything the rules and the search need to know about a position, as plain data.
+// Board wraps one and keeps it consistent; copying a Position is a memcpy, so it can
+// be snapshotted, handed to another thread or used for copy-make without touching
+// the heap. The move history lives in Board, not here.
+struct Position
+{
+    Bitboard typeBB[6];         // One mask per piece type (both colors), indexed by PieceType
+    Bitboard colorBB[2];        // Occupancy mask per color, indexed by Color
+    Bitboard attackedBB[2];     // Squares attacked by each side, rebuilt by every move
+    uint64_t hashKey;           // Zobrist key of the position, kept up to date by every move
+    PieceCode mailbox[64];      // Piece on each square (NO_PIECE if empty), kept in step with the masks
+    // The masks double as piece lists (popLsb() only visits existing pieces); these
+    // are kept next to them so king lookups and material counts need no bit scan
+    int kingSq[2];              // NO_SQUARE if the side has no king
+    uint8_t pieceCounts[2][6];  // Indexed by [Color][PieceType]
+    int castlingRights;         // CastlingRight bits that are still available
+    int enPassantSquare;        // Square a pawn can capture onto en passant, or NO_SQUARE
+    Color sideToMove;
+    int halfmoveClock;          // Moves since the last capture or pawn move
+    int fullmoveNumber;         // Starts at 1 and goes up after each Black move, as in FEN
+};
+
+static_assert(std::is_trivially_copyable<Position>::value, "Position must stay copyable with memcpy");
+
+#endif // POSITION_H
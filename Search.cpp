@@ -0,0 +1,393 @@
+#include "Search.h"
+#include <cmath>
+#include "Board.h"
+#include "Evaluation.h"
+
+namespace
+{
+    // Delta pruning: a capture that cannot lift the static score to alpha even with
+    // this much positional gain on top of the victim is not searched
+    const int DELTA_MARGIN = 200;
+
+    // History reward for a quiet move that caused a cutoff, bigger for deeper, more
+    // trustworthy results
+    int historyBonus(int depth) { return min(32 * depth * depth, 2048); }
+
+    // Null-move pruning: the pass is searched this much shallower (more at greater depths)
+    const int NULL_MOVE_REDUCTION = 3;
+    const int NULL_MOVE_MIN_DEPTH = 3;
+
+    // Late move reductions apply from this depth and this many moves into a node on
+    const int LMR_MIN_DEPTH = 3;
+    const int LMR_MIN_MOVES = 4;
+
+    // Plies to take off a late quiet move, by [depth][move number]: grows with the
+    // logarithm of both, so deep nodes with many moves are reduced most
+    struct ReductionTable
+    {
+        int8_t plies[MAX_PLY][MAX_MOVES];
+    };
+
+    ReductionTable buildReductionTable()
+    {
+        ReductionTable table = {};
+        for (int depth = 1; depth < MAX_PLY; ++depth)
+        {
+            for (int moveNumber = 1; moveNumber < MAX_MOVES; ++moveNumber)
+                table.plies[depth][moveNumber] = int8_t(0.75 + log(depth) * log(moveNumber) / 2.25);
+        }
+        return table;
+    }
+
+    const ReductionTable REDUCTIONS = buildReductionTable();
+
+    // Pieces besides pawns and the king. With none of them passing may well be the best
+    // "move" (zugzwang), so a null move proves nothing.
+    int nonPawnPieces(const Board &board, Color side)
+    {
+        return board.pieceCount(side, KNIGHT) + board.pieceCount(side, BISHOP) + board.pieceCount(side, ROOK) +
+               board.pieceCount(side, QUEEN);
+    }
+}
+
+using namespace std;
+
+Search::Search(TranspositionTable &tt, int threadId, const atomic<bool> *stopSignal)
+    : tt(&tt), threadId(threadId), stopSignal(stopSignal), nodes(0), qnodes(0), failHighs(0),
+      failHighsFirst(0), nullMoveMinPly(0), stopped(false)
+{
+    for (int &length : pvLength)
+        length = 0;
+    pvTable[0][0] = MOVE_NONE;
+}
+
+SearchResult Search::run(Board &board, const SearchLimits &searchLimits)
+{
+    limits = searchLimits;
+    startTime = chrono::steady_clock::now();
+    nodes = 0;
+    qnodes = 0;
+    failHighs = 0;
+    failHighsFirst = 0;
+    hashStats = TTStats();
+    nullMoveMinPly = 0;
+    stopped = false;
+    quietHistory.age();
+    for (Move *slots : killers)
+    {
+        for (int i = 0; i < MovePicker::KILLER_SLOTS; ++i)
+            slots[i] = MOVE_NONE;
+    }
+
+    SearchResult result;
+    MoveBuffer rootMoves;
+    board.generateLegalMoves(board.getSideToMove(), rootMoves);
+    if (!rootMoves.empty())
+    {
+        // Something to play even if the first iteration is cut short
+        result.hasMove = true;
+        result.bestMove = rootMoves[0];
+        result.pv[0] = rootMoves[0];
+        result.pvLength = 1;
+
+        // No PV from an earlier search: it belongs to another position
+        pvTable[0][0] = MOVE_NONE;
+        pvLength[0] = 0;
+
+        int maxDepth = limits.maxDepth > 0 ? min(limits.maxDepth, MAX_PLY - 1) : MAX_PLY - 1;
+        for (int depth = 1; depth <= maxDepth; ++depth)
+        {
+            if (skipsDepth(depth))
+                continue;
+
+            int score = negamax(board, depth, 0, -INFINITE_SCORE, INFINITE_SCORE);
+            if (stopped)
+                break; // An unfinished iteration is not trusted
+
+            result.score = score;
+            result.depth = depth;
+            result.pvLength = pvLength[0];
+            for (int i = 0; i < pvLength[0]; ++i)
+                result.pv[i] = pvTable[0][i];
+            result.bestMove = result.pv[0];
+
+            // A forced mate will not get any better with more depth
+            if (score >= MATE_BOUND || score <= -MATE_BOUND)
+                break;
+        }
+    }
+
+    result.nodes = nodes;
+    result.qnodes = qnodes;
+    result.failHighs = failHighs;
+    result.failHighsFirst = failHighsFirst;
+    result.hashStats = hashStats;
+    result.elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - startTime).count();
+    return result;
+}
+
+int Search::scoreToTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)
+        return score + ply;
+    if (score <= -MATE_BOUND)
+        return score - ply;
+    return score;
+}
+
+int Search::scoreFromTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)
+        return score - ply;
+    if (score <= -MATE_BOUND)
+        return score + ply;
+    return score;
+}
+
+// Helpers leave out a different pattern of depths each, so at any time the threads
+// are spread over the current depth and the next ones instead of all repeating the
+// same work. The main search (threadId 0) runs every depth.
+bool Search::skipsDepth(int depth) const
+{
+    static const int SKIP_SIZE[] = {1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 4, 4, 4, 4, 4, 4, 4, 4};
+    static const int SKIP_PHASE[] = {0, 1, 0, 1, 2, 3, 0, 1, 2, 3, 4, 5, 0, 1, 2, 3, 4, 5, 6, 7};
+    if (threadId == 0)
+        return false;
+    int i = (threadId - 1) % 20;
+    return ((depth + SKIP_PHASE[i]) / SKIP_SIZE[i]) % 2 != 0;
+}
+
+bool Search::shouldStop()
+{
+    if (stopSignal && stopSignal->load(memory_order_relaxed))
+        return true;
+    if (limits.timeLimitMs <= 0)
+        return false;
+    auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - startTime);
+    return elapsed.count() >= limits.timeLimitMs;
+}
+
+int Search::negamax(Board &board, int depth, int ply, int alpha, int beta)
+{
+    if (depth <= 0)
+        return quiescence(board, ply, alpha, beta);
+
+    pvLength[ply] = ply;
+
+    if ((++nodes & 2047) == 0 && shouldStop())
+        stopped = true;
+    if (stopped)
+        return 0;
+
+    if (ply >= MAX_PLY - 1)
+        return evaluate(board);
+
+    // A deep enough stored result settles the node without searching it. The root is
+    // always searched so that it produces a best move and a PV.
+    uint64_t key = board.getHashKey();
+    TTEntry entry;
+    bool ttHit = tt->probe(key, entry);
+    ++(ttHit ? hashStats.hits : hashStats.misses);
+    if (ttHit && ply > 0 && entry.depth >= depth)
+    {
+        int score = scoreFromTT(entry.score, ply);
+        if (entry.bound == BOUND_EXACT ||
+            (entry.bound == BOUND_LOWER && score >= beta) ||
+            (entry.bound == BOUND_UPPER && score <= alpha))
+            return score;
+    }
+
+    // At the root the previous iteration's best move is searched first, elsewhere the stored one
+    Move hashMove = MOVE_NONE;
+    if (ply == 0)
+        hashMove = pvTable[0][0];
+    else if (ttHit && entry.hasMove)
+        hashMove = entry.move;
+    Color side = board.getSideToMove();
+    Move previous = board.previousMove();
+    bool inCheck = board.inCheck();
+
+    // Null move: if passing still fails high after a shallower search, a real move will
+    // too. Not in check, not twice in a row, and not without pieces (zugzwang).
+    int sidePieces = nonPawnPieces(board, side);
+    if (limits.nullMove && ply >= nullMoveMinPly && ply > 0 && depth >= NULL_MOVE_MIN_DEPTH && !inCheck &&
+        previous != MOVE_NONE && sidePieces > 0 && beta < MATE_BOUND && evaluate(board) >= beta)
+    {
+        int nullDepth = depth - 1 - NULL_MOVE_REDUCTION - depth / 6;
+        board.makeNullMove();
+        int score = -negamax(board, nullDepth, ply + 1, -beta, -beta + 1);
+        board.unmakeNullMove();
+        if (stopped)
+            return 0;
+
+        if (score >= beta)
+        {
+            // A mate found after a pass proves nothing. MATE_BOUND itself already reads as
+            // a mate, so stay just below it.
+            score = min(score, MATE_BOUND - 1);
+            if (sidePieces > 2)
+                return score;
+
+            // Few pieces left, so zugzwang is possible: confirm with a shallower real search
+            // of this node, without null moves
+            int savedMinPly = nullMoveMinPly;
+            nullMoveMinPly = MAX_PLY;
+            int verified = negamax(board, nullDepth, ply, beta - 1, beta);
+            nullMoveMinPly = savedMinPly;
+            pvLength[ply] = ply;
+            if (stopped)
+                return 0;
+            if (verified >= beta)
+                return score;
+        }
+    }
+
+    Move counterMove = MOVE_NONE;
+    if (previous != MOVE_NONE)
+        counterMove = quietHistory.counterMoves[board.pieceAt(previous.to())][previous.to()];
+    MovePicker picker(board, hashMove, killers[ply], counterMove, &quietHistory);
+
+    int originalAlpha = alpha;
+    Move bestMove = MOVE_NONE;
+    int legalMoves = 0;
+    for (Move move = picker.next(); move != MOVE_NONE; move = picker.next())
+    {
+        ++legalMoves;
+        // Decided before the move is made, while the target square still shows any victim
+        bool quiet = board.pieceAt(move.to()) == NO_PIECE && move.flag() != EN_PASSANT && !move.isPromotion();
+
+        board.makeMove(move);
+        int score;
+        // Late quiet moves rarely matter: search them shallower with a null window, and
+        // only search one fully if it unexpectedly beats alpha. Checks are never reduced.
+        int reduction = 0;
+        if (limits.lateMoveReductions && quiet && depth >= LMR_MIN_DEPTH && legalMoves >= LMR_MIN_MOVES &&
+            !inCheck && !board.inCheck() && move != killers[ply][0] && move != killers[ply][1] &&
+            move != counterMove)
+            reduction = min(int(REDUCTIONS.plies[depth][legalMoves]), depth - 2);
+        if (reduction > 0)
+        {
+            score = -negamax(board, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && !stopped)
+                score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+        }
+        else
+            score = -negamax(board, depth - 1, ply + 1, -beta, -alpha);
+        board.unmakeMove();
+
+        if (stopped)
+            return 0;
+
+        if (score > alpha)
+        {
+            alpha = score;
+            bestMove = move;
+
+            // Best line = this move followed by the child's best line
+            pvTable[ply][ply] = move;
+            for (int next = ply + 1; next < pvLength[ply + 1]; ++next)
+                pvTable[ply][next] = pvTable[ply + 1][next];
+            pvLength[ply] = pvLength[ply + 1];
+
+            if (alpha >= beta)
+            {
+                ++failHighs;
+                if (legalMoves == 1)
+                    ++failHighsFirst;
+
+                // The opponent will avoid this line. A quiet refutation is likely to
+                // refute the sibling positions too, and the reply to the same move elsewhere.
+                if (quiet)
+                {
+                    if (killers[ply][0] != move)
+                    {
+                        killers[ply][1] = killers[ply][0];
+                        killers[ply][0] = move;
+                    }
+                    quietHistory.update(side, move, historyBonus(depth));
+                    if (previous != MOVE_NONE)
+                        quietHistory.counterMoves[board.pieceAt(previous.to())][previous.to()] = move;
+                }
+                break;
+            }
+        }
+    }
+
+    if (legalMoves == 0)
+    {
+        // Checkmated (prefer the longest defence) or stalemated
+        return inCheck ? -MATE_SCORE + ply : 0;
+    }
+
+    BoundType bound = alpha >= beta ? BOUND_LOWER : alpha > originalAlpha ? BOUND_EXACT : BOUND_UPPER;
+    if (tt->store(key, bestMove != MOVE_NONE ? &bestMove : nullptr, scoreToTT(alpha, ply), depth, bound))
+        ++hashStats.collisions;
+    return alpha;
+}
+
+int Search::quiescence(Board &board, int ply, int alpha, int beta)
+{
+    pvLength[ply] = ply;
+    ++qnodes;
+    if ((++nodes & 2047) == 0 && shouldStop())
+        stopped = true;
+    if (stopped)
+        return 0;
+    if (ply >= MAX_PLY - 1)
+        return evaluate(board);
+
+    // In check there is no standing pat: every evasion is searched, so mates are seen
+    if (board.inCheck())
+    {
+        MovePicker picker(board, MOVE_NONE);
+        int legalMoves = 0;
+        for (Move move = picker.next(); move != MOVE_NONE; move = picker.next())
+        {
+            ++legalMoves;
+            board.makeMove(move);
+            int score = -quiescence(board, ply + 1, -beta, -alpha);
+            board.unmakeMove();
+            if (stopped)
+                return 0;
+            if (score > alpha)
+            {
+                alpha = score;
+                if (alpha >= beta)
+                    break;
+            }
+        }
+        return legalMoves == 0 ? -MATE_SCORE + ply : alpha;
+    }
+
+    // Stand pat: the side to move does not have to capture
+    int standPat = evaluate(board);
+    if (standPat >= beta)
+        return standPat;
+    if (standPat > alpha)
+        alpha = standPat;
+
+    // Only captures that do not lose material by SEE come out of the picker
+    MovePicker picker(board);
+    for (Move move = picker.next(); move != MOVE_NONE; move = picker.next())
+    {
+        PieceType victim = move.flag() == EN_PASSANT ? PAWN : board.pieceTypeAt(move.to());
+        int gain = victim == NO_PIECE_TYPE ? 0 : PIECE_VALUES[victim];
+        if (move.isPromotion())
+            gain += PIECE_VALUES[QUEEN] - PIECE_VALUES[PAWN];
+        if (standPat + gain + DELTA_MARGIN <= alpha)
+            continue;
+
+        board.makeMove(move);
+        int score = -quiescence(board, ply + 1, -beta, -alpha);
+        board.unmakeMove();
+        if (stopped)
+            return 0;
+        if (score > alpha)
+        {
+            alpha = score;
+            if (alpha >= beta)
+                break;
+        }
+    }
+    return alpha;
+}
@@ -0,0 +1,108 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "Move.h"
+#include "MovePicker.h"
+#include "TranspositionTable.h"
+
+class Board;
+
+// Deepest line the search can follow
+const int MAX_PLY = 64;
+
+// Score bounds in centipawns. Mate scores are MATE_SCORE minus the distance to mate in plies.
+const int INFINITE_SCORE = 32000;
+const int MATE_SCORE = 31000;
+const int MATE_BOUND = MATE_SCORE - MAX_PLY; // Anything above this is a forced mate
+
+// When to stop iterative deepening, and how selective to be on the way. A zero depth or
+// time means "no limit" for that field, but at least one of them should be set.
+struct SearchLimits
+{
+    int maxDepth;            // Deepest iteration to run
+    int timeLimitMs;         // Wall-clock budget for the whole search
+    bool nullMove;           // Null-move pruning
+    bool lateMoveReductions; // Search late quiet moves shallower, and again if they fail high
+
+    SearchLimits(int maxDepth = 4, int timeLimitMs = 0)
+        : maxDepth(maxDepth), timeLimitMs(timeLimitMs), nullMove(true), lateMoveReductions(true) {}
+};
+
+struct SearchResult
+{
+    Move bestMove;
+    bool hasMove;        // False when the side to move has no legal move
+    int score;           // From the point of view of the side to move
+    int depth;           // Last iteration that completed
+    Move pv[MAX_PLY];    // Principal variation, starting with bestMove
+    int pvLength;
+    uint64_t nodes;      // Positions visited, over all iterations
+    uint64_t qnodes;     // The part of nodes visited by quiescence search
+    // Move ordering quality: beta cutoffs, and how many of them came from the first move tried
+    uint64_t failHighs;
+    uint64_t failHighsFirst;
+    TTStats hashStats;   // This search's probes and stores
+    double elapsedMs;
+
+    SearchResult()
+        : hasMove(false), score(0), depth(0), pvLength(0), nodes(0), qnodes(0), failHighs(0), failHighsFirst(0),
+          elapsedMs(0) {}
+
+    double nodesPerSecond() const { return elapsedMs > 0 ? nodes * 1000.0 / elapsedMs : 0; }
+    double failHighFirstRate() const { return failHighs > 0 ? failHighsFirst * 100.0 / failHighs : 0; }
+};
+
+// Negamax alpha-beta search with iterative deepening.
+// The board is searched in place with makeMove/unmakeMove and is left unchanged.
+// Results are shared through the transposition table, which the caller owns; the caller
+// also starts each new search on the table (TranspositionTable::newSearch).
+//
+// One Search is one thread's worth of state. It is cache-line aligned so that the
+// searches of different threads (see ParallelSearch) never share a line.
+class alignas(64) Search
+{
+public:
+    // threadId 0 is the main search. Helpers (threadId > 0) skip some iteration depths
+    // so that the threads spread over different depths. All searches stop once
+    // stopSignal (if any) is set.
+    explicit Search(TranspositionTable &tt, int threadId = 0, const std::atomic<bool> *stopSignal = nullptr);
+
+    SearchResult run(Board &board, const SearchLimits &limits);
+
+private:
+    int negamax(Board &board, int depth, int ply, int alpha, int beta);
+    // Captures only, from the leaves on, until the position is quiet
+    int quiescence(Board &board, int ply, int alpha, int beta);
+    bool shouldStop();
+    bool skipsDepth(int depth) const;
+
+    // Mate scores are stored as distance from the stored position, not from the root
+    static int scoreToTT(int score, int ply);
+    static int scoreFromTT(int score, int ply);
+
+    // Triangular principal-variation table: pvTable[ply] holds the best line from ply onwards
+    Move pvTable[MAX_PLY][MAX_PLY];
+    int pvLength[MAX_PLY];
+    // Quiet moves that caused a beta cutoff at each ply, newest first (see MovePicker)
+    Move killers[MAX_PLY][MovePicker::KILLER_SLOTS];
+    // Butterfly history and countermoves, kept (and aged) from one search to the next
+    QuietHistory quietHistory;
+
+    TranspositionTable *tt;
+    int threadId;
+    const std::atomic<bool> *stopSignal;
+    SearchLimits limits;
+    std::chrono::steady_clock::time_point startTime;
+    uint64_t nodes;
+    uint64_t qnodes;
+    uint64_t failHighs;
+    uint64_t failHighsFirst;
+    TTStats hashStats;
+    int nullMoveMinPly; // Null moves are only tried from this ply on (none while a null-move cutoff is verified)
+    bool stopped;
+};
+
+#endif // SEARCH_H
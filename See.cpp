@@ -0,0 +1,96 @@
+#include "See.h"
+#include <algorithm>
+#include "Evaluation.h"
+
+using namespace std;
+
+namespace
+{
+    // PIECE_VALUES, with a king worth more than anything it could win: it only ever
+    // recaptures last, since taking a defended piece would be illegal
+    const int SEE_VALUES[7] = {PIECE_VALUES[PAWN], PIECE_VALUES[KNIGHT], PIECE_VALUES[BISHOP],
+                               PIECE_VALUES[ROOK], PIECE_VALUES[QUEEN], 20000, 0};
+
+    PieceType victimOf(const Board &board, Move move)
+    {
+        return move.flag() == EN_PASSANT ? PAWN : board.pieceTypeAt(move.to());
+    }
+}
+
+int see(const Board &board, Move move)
+{
+    int from = move.from();
+    int to = move.to();
+    Color side = opposite(board.colorAt(from));
+
+    // gain[d] = what the side making capture d has won so far, if the exchange stops there
+    int gain[32];
+    int depth = 0;
+    gain[0] = SEE_VALUES[victimOf(board, move)];
+    PieceType onSquare = board.pieceTypeAt(from); // The piece the next capture removes
+    if (move.isPromotion())
+    {
+        onSquare = move.promotionType();
+        gain[0] += SEE_VALUES[onSquare] - SEE_VALUES[PAWN];
+    }
+
+    Bitboard occ = board.occupied() ^ squareBB(from);
+    if (move.flag() == EN_PASSANT)
+        occ ^= squareBB(toSquare(move.startX(), move.endY()));
+    Bitboard rookLike = board.pieces(ROOK) | board.pieces(QUEEN);
+    Bitboard bishopLike = board.pieces(BISHOP) | board.pieces(QUEEN);
+    Bitboard attackers = board.attackersTo(to, occ) & occ;
+
+    while (true)
+    {
+        Bitboard ours = attackers & board.pieces(side);
+        if (!ours)
+            break;
+
+        // Least valuable attacker first
+        PieceType type = PAWN;
+        while (!(ours & board.pieces(type)))
+            type = PieceType(type + 1);
+        int sq = lsb(ours & board.pieces(type));
+
+        // The king cannot capture onto a square the other side still attacks
+        if (type == KING && (attackers & board.pieces(opposite(side))))
+            break;
+
+        ++depth;
+        gain[depth] = SEE_VALUES[onSquare] - gain[depth - 1];
+        // If this side loses whether it stops before the capture or right after it, the
+        // sign of the exchange is settled and the rest of it cannot change the outcome
+        if (max(-gain[depth - 1], gain[depth]) < 0)
+        {
+            --depth;
+            break;
+        }
+
+        // Taking the capturer off may uncover a slider lined up behind it
+        occ ^= squareBB(sq);
+        if (type == PAWN || type == BISHOP || type == QUEEN)
+            attackers |= bishopAttacks(to, occ) & bishopLike;
+        if (type == ROOK || type == QUEEN)
+            attackers |= rookAttacks(to, occ) & rookLike;
+        attackers &= occ;
+
+        onSquare = type;
+        side = opposite(side);
+    }
+
+    // Each side may stop instead of recapturing: fold the choices back to the first move
+    while (depth > 0)
+    {
+        --depth;
+        gain[depth] = -max(-gain[depth], gain[depth + 1]);
+    }
+    return gain[0];
+}
+
+bool seeLoses(const Board &board, Move move)
+{
+    if (!move.isPromotion() && SEE_VALUES[victimOf(board, move)] >= SEE_VALUES[board.pieceTypeAt(move.from())])
+        return false;
+    return see(board, move) < 0;
+}
@@ -0,0 +1,18 @@
+#ifndef SEE_H
+#define SEE_H
+
+#include "Board.h"
+
+// Static exchange evaluation: the material the side to move wins (negative if it
+// loses material) by playing move and then letting both sides recapture on the
+// target square, least valuable piece first, each side free to stop when going on
+// would lose. No move is made: the capturers are taken off a copy of the occupancy,
+// which also uncovers the sliders behind them (x-rays). Pins are not considered.
+// Quiet moves are valued too: the result is what the moved piece can lose there.
+int see(const Board &board, Move move);
+
+// Cheaper when only the sign matters: a capture of a piece worth at least the
+// capturer can never lose material, so it needs no exchange at all
+bool seeLoses(const Board &board, Move move);
+
+#endif // SEE_H
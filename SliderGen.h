@@ -0,0 +1,69 @@
+#ifndef SLIDER_GEN_H
+#define SLIDER_GEN_H
+
+#include "Bitboard.h"
+
+// Compile-time helpers shared by the slider table builders (Magic.cpp, Pext.cpp)
+// and tools/magicgen.cpp. Everything here is slow and only meant for building tables.
+namespace SliderGen
+{
+    constexpr int ROOK_DX[4] = {-1, 1, 0, 0};
+    constexpr int ROOK_DY[4] = {0, 0, 1, -1};
+    constexpr int BISHOP_DX[4] = {-1, -1, 1, 1};
+    constexpr int BISHOP_DY[4] = {1, -1, 1, -1};
+
+    constexpr bool onBoard(int x, int y) { return x >= 0 && x < 8 && y >= 0 && y < 8; }
+
+    constexpr int countBits(Bitboard b)
+    {
+        int count = 0;
+        for (; b; b &= b - 1)
+            ++count;
+        return count;
+    }
+
+    // Attacks found by walking each ray until the first blocker
+    constexpr Bitboard slidingAttacks(int sq, Bitboard occupied, const int *dx, const int *dy)
+    {
+        Bitboard attacks = 0;
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            for (int x = squareRow(sq) + dx[dir], y = squareCol(sq) + dy[dir]; onBoard(x, y); x += dx[dir], y += dy[dir])
+            {
+                attacks |= squareBB(toSquare(x, y));
+                if (occupied & squareBB(toSquare(x, y)))
+                    break;
+            }
+        }
+        return attacks;
+    }
+
+    // Parallel bit deposit: spreads the low bits of value over the set bits of mask
+    // (the inverse of pext), used to enumerate the blocker sets in PEXT index order
+    constexpr Bitboard depositBits(Bitboard value, Bitboard mask)
+    {
+        Bitboard result = 0;
+        for (Bitboard bit = 1; mask; mask &= mask - 1, bit <<= 1)
+        {
+            if (value & bit)
+                result |= mask & (0 - mask);
+        }
+        return result;
+    }
+
+    // Squares whose occupancy matters: the rays without their last square,
+    // since a piece there cannot block anything further
+    constexpr Bitboard relevanceMask(int sq, const int *dx, const int *dy)
+    {
+        Bitboard mask = 0;
+        for (int dir = 0; dir < 4; ++dir)
+        {
+            for (int x = squareRow(sq) + dx[dir], y = squareCol(sq) + dy[dir];
+                 onBoard(x + dx[dir], y + dy[dir]); x += dx[dir], y += dy[dir])
+                mask |= squareBB(toSquare(x, y));
+        }
+        return mask;
+    }
+}
+
+#endif // SLIDER_GEN_H
@@ -35,4 +35,9 @@ size_t Stack<T>::size() const {
     return data.size();  // Return the size of the underlying vector
 }
 
+template <typename T>
+const T& Stack<T>::at(size_t index) const {
+    return data[index];  // Unchecked: callers check size() first, some of them once per search node
+}
+
 #endif
\ No newline at end of file
@@ -21,6 +21,10 @@ public:
     // Return the size of the stack
     size_t size() const;
 
+    // Read an element without popping (index 0 is the bottom of the stack).
+    // Not bounds-checked: index must be below size().
+    const T& at(size_t index) const;
+
 private:
     std::vector<T> data;
 };
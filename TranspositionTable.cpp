@@ -0,0 +1,116 @@
+#include "TranspositionTable.h"
+#include <climits>
+
+using namespace std;
+
+namespace
+{
+    // Layout of the data word:
+    //   bits  0-15  move (Move::raw()), MOVE_NONE when there is none
+    //   bits 16-31  score (int16)
+    //   bits 32-39  depth (int8)
+    //   bits 40-41  bound
+    //   bits 48-55  generation
+    // A move never starts and ends on the same square, so a packed move of 0 means "no move".
+
+    uint64_t packData(const Move *move, int score, int depth, BoundType bound, uint8_t generation)
+    {
+        uint64_t packedMove = move ? move->raw() : MOVE_NONE.raw();
+        return packedMove | uint64_t(uint16_t(int16_t(score))) << 16 | uint64_t(uint8_t(int8_t(depth))) << 32 |
+               uint64_t(bound) << 40 | uint64_t(generation) << 48;
+    }
+
+    uint16_t moveOf(uint64_t data) { return uint16_t(data & 0xFFFF); }
+    int scoreOf(uint64_t data) { return int16_t(uint16_t(data >> 16)); }
+    int depthOf(uint64_t data) { return int8_t(uint8_t(data >> 32)); }
+    BoundType boundOf(uint64_t data) { return BoundType((data >> 40) & 3); }
+    uint8_t generationOf(uint64_t data) { return uint8_t(data >> 48); }
+}
+
+TranspositionTable::TranspositionTable(size_t megabytes)
+    : bucketCount(0), generation(0)
+{
+    resize(megabytes);
+}
+
+void TranspositionTable::resize(size_t megabytes)
+{
+    size_t wanted = max<size_t>(megabytes, 1) * 1024 * 1024 / sizeof(Bucket);
+    bucketCount = 1;
+    while (bucketCount * 2 <= wanted)
+        bucketCount *= 2;
+
+    buckets.reset(new Bucket[bucketCount]);
+    clear();
+}
+
+void TranspositionTable::clear()
+{
+    for (size_t i = 0; i < bucketCount; ++i)
+    {
+        for (Slot &slot : buckets[i].slots)
+        {
+            slot.keyXorData.store(0, memory_order_relaxed);
+            slot.data.store(0, memory_order_relaxed);
+        }
+    }
+    generation = 0;
+}
+
+bool TranspositionTable::probe(uint64_t key, TTEntry &entry)
+{
+    for (Slot &slot : bucketFor(key).slots)
+    {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        if ((slot.keyXorData.load(memory_order_relaxed) ^ data) != key || boundOf(data) == BOUND_NONE)
+            continue;
+
+        entry.move = Move::fromRaw(moveOf(data));
+        entry.hasMove = entry.move != MOVE_NONE;
+        entry.score = scoreOf(data);
+        entry.depth = depthOf(data);
+        entry.bound = boundOf(data);
+        return true;
+    }
+    return false;
+}
+
+bool TranspositionTable::store(uint64_t key, const Move *move, int score, int depth, BoundType bound)
+{
+    Slot *target = nullptr;
+    int targetValue = INT_MAX;
+    for (Slot &slot : bucketFor(key).slots)
+    {
+        uint64_t data = slot.data.load(memory_order_relaxed);
+        uint64_t storedKey = slot.keyXorData.load(memory_order_relaxed) ^ data;
+
+        if (boundOf(data) != BOUND_NONE && storedKey == key)
+        {
+            // Same position: a shallower result from this search is only worth less
+            // when it does not carry an exact score
+            if (bound != BOUND_EXACT && depth + 2 < depthOf(data) && generationOf(data) == generation)
+                return false;
+            uint64_t newData = packData(move, score, depth, bound, generation);
+            if (!move)
+                newData |= uint64_t(moveOf(data)); // Keep the old best move rather than losing it
+            slot.data.store(newData, memory_order_relaxed);
+            slot.keyXorData.store(key ^ newData, memory_order_relaxed);
+            return false;
+        }
+
+        // Empty slots go first, then old and shallow results
+        int value = boundOf(data) == BOUND_NONE
+                        ? INT_MIN
+                        : depthOf(data) - 8 * ((generation - generationOf(data)) & 0xFF);
+        if (value < targetValue)
+        {
+            target = &slot;
+            targetValue = value;
+        }
+    }
+
+    uint64_t newData = packData(move, score, depth, bound, generation);
+    target->data.store(newData, memory_order_relaxed);
+    target->keyXorData.store(key ^ newData, memory_order_relaxed);
+    return targetValue != INT_MIN;
+}
@@ -0,0 +1,87 @@
+#ifndef TRANSPOSITION_TABLE_H
+#define TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Move.h"
+
+// What a stored score says about the real score of the position
+enum BoundType
+{
+    BOUND_NONE = 0,
+    BOUND_UPPER, // Failed low: the real score is at most this
+    BOUND_LOWER, // Failed high: the real score is at least this
+    BOUND_EXACT
+};
+
+// Unpacked copy of a table entry, handed out by probe()
+struct TTEntry
+{
+    Move move;    // Best move found, only meaningful if hasMove
+    bool hasMove;
+    int score;    // Mate scores are relative to the stored position, see Search
+    int depth;
+    BoundType bound;
+};
+
+// Hit, miss and collision counts. Each search keeps its own (see SearchResult), so the
+// shared table has no counters for the threads to fight over.
+struct TTStats
+{
+    uint64_t hits;       // Probes that found their position
+    uint64_t misses;     // Probes that did not
+    uint64_t collisions; // Stores that evicted a different position from a full bucket
+
+    TTStats() : hits(0), misses(0), collisions(0) {}
+
+    double hitRate() const { return hits + misses > 0 ? hits * 100.0 / (hits + misses) : 0; }
+};
+
+// Hash table of search results keyed by the Zobrist key of the position.
+//
+// Every slot is two 64-bit words: the packed data and the key XOR the data. A reader
+// accepts a slot only if the two words XOR back to its key, so a slot torn by two
+// threads writing at once reads as a miss instead of as wrong data, and no lock is needed.
+// Four slots make a 64-byte bucket, so a probe touches a single cache line.
+class TranspositionTable
+{
+public:
+    static const int BUCKET_SIZE = 4;
+
+    // Size in megabytes, rounded down to a power-of-two number of buckets
+    explicit TranspositionTable(size_t megabytes = 16);
+
+    void resize(size_t megabytes);
+    void clear();
+    // Starts a new search: entries from earlier searches become the first to be replaced
+    void newSearch() { generation = (generation + 1) & 0xFF; }
+
+    bool probe(uint64_t key, TTEntry &entry);
+    // Keeps the deeper and more recent results when the bucket is full. Returns true if
+    // that evicted a different position (a collision).
+    bool store(uint64_t key, const Move *move, int score, int depth, BoundType bound);
+
+    size_t getSizeBytes() const { return bucketCount * sizeof(Bucket); }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> keyXorData;
+        std::atomic<uint64_t> data;
+    };
+
+    struct alignas(64) Bucket
+    {
+        Slot slots[BUCKET_SIZE];
+    };
+
+    Bucket &bucketFor(uint64_t key) { return buckets[key & (bucketCount - 1)]; }
+
+    std::unique_ptr<Bucket[]> buckets;
+    size_t bucketCount;
+    uint8_t generation;
+};
+
+#endif // TRANSPOSITION_TABLE_H
@@ -0,0 +1,38 @@
+#include "Zobrist.h"
+
+namespace
+{
+    // SplitMix64: small, fast and good enough to fill the key table
+    constexpr uint64_t nextRandom(uint64_t &state)
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    constexpr ZobristKeys buildZobristKeys()
+    {
+        ZobristKeys keys{};
+        uint64_t state = 0x51A7E5C0FFEEULL;
+        for (int color = 0; color < 2; ++color)
+            for (int type = 0; type < 6; ++type)
+                for (int sq = 0; sq < 64; ++sq)
+                    keys.piece[color][type][sq] = nextRandom(state);
+
+        // No rights hashes to zero, combined rights are the XOR of the single ones
+        uint64_t single[4] = {nextRandom(state), nextRandom(state), nextRandom(state), nextRandom(state)};
+        for (int rights = 0; rights < 16; ++rights)
+            for (int bit = 0; bit < 4; ++bit)
+                if (rights & (1 << bit))
+                    keys.castling[rights] ^= single[bit];
+
+        for (int file = 0; file < 8; ++file)
+            keys.enPassantFile[file] = nextRandom(state);
+        keys.blackToMove = nextRandom(state);
+        return keys;
+    }
+}
+
+extern const ZobristKeys ZOBRIST;
+constexpr ZobristKeys ZOBRIST = buildZobristKeys();
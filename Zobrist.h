@@ -0,0 +1,20 @@
+#ifndef ZOBRIST_H
+#define ZOBRIST_H
+
+#include <cstdint>
+#include "Bitboard.h"
+
+// Random keys for Zobrist hashing. A position's key is the XOR of the keys of
+// everything in it, so Board can update it with a few XORs per move.
+struct ZobristKeys
+{
+    uint64_t piece[2][6][64];   // [Color][PieceType][square]
+    uint64_t castling[16];      // One per combination of CastlingRight bits
+    uint64_t enPassantFile[8];  // Column of the en-passant square, if there is one
+    uint64_t blackToMove;
+};
+
+// Generated at compile time from a fixed seed, so keys are identical across runs and builds
+extern const ZobristKeys ZOBRIST;
+
+#endif // ZOBRIST_H
@@ -0,0 +1,511 @@
+// Bench: fixed workloads for measuring engine changes.
+//
+// Usage:
+//   bench smp [--depth D] [--threads MAX] [--hash MB] [--no-null] [--no-lmr]
+//       Searches the bench positions to depth D (default 8) with 1, 2, 4, ... MAX threads
+//       (default: all cores) and reports nodes (and how many of them were quiescence nodes),
+//       nodes per second and time to depth per thread count. --no-null and --no-lmr turn
+//       off null-move pruning and late move reductions.
+//   bench pruning [--depth D] [--hash MB]
+//       Searches the bench positions to depth D (default 8) on one thread without pruning,
+//       with null move only, with late move reductions only and with both. Reports nodes
+//       and time to depth, and how far the results stray from the full-width search:
+//       positions with a different best move and the mean score difference.
+//   bench movegen [--depth D]
+//       Perft of the bench positions to depth D (default 4), then the speed of each
+//       generation stage (captures, quiets, evasions) over the positions met on the way.
+//   bench sliders [--depth D]
+//       Compares the sliding-attack backends (magic, and PEXT if the CPU has fast BMI2):
+//       raw lookups per second, then perft of the bench positions to depth D (default 4).
+//   bench see
+//       Static exchange evaluation speed over every capture in the positions two plies
+//       from the bench positions, for the full value and for the cheaper sign test.
+//   bench boards [--games N] [--threads MAX]
+//       Stress test for independent boards: plays N (default 4000) seeded random games on
+//       MAX threads at once, each on its own Board, and checks every game ends exactly as
+//       it does when played alone. Exits with 1 on any difference.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Board.h"
+#include "ParallelSearch.h"
+#include "See.h"
+
+using namespace std;
+
+namespace
+{
+    // Quiet and tactical middlegame positions plus an endgame
+    const char *const BENCH_POSITIONS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1B1PPP/R2QKB1R w KQ - 0 8",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+
+    const size_t BENCH_POSITION_COUNT = sizeof(BENCH_POSITIONS) / sizeof(BENCH_POSITIONS[0]);
+
+    struct BenchOptions
+    {
+        int depth;     // 0 = the section's default
+        int threads;   // Most threads to try
+        size_t hashMb;
+        int games;     // Games played by the boards stress test
+        bool nullMove; // Search switches for the smp section
+        bool lateMoveReductions;
+
+        BenchOptions()
+            : depth(0), threads(max(1, int(thread::hardware_concurrency()))), hashMb(64), games(4000), nullMove(true),
+              lateMoveReductions(true) {}
+    };
+
+    volatile Bitboard lookupSink; // Keeps the compiler from dropping the timed lookups
+
+    double millisecondsSince(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+
+    uint64_t perft(Board &board, int depth)
+    {
+        MoveBuffer moves;
+        board.generateLegalMoves(board.getSideToMove(), moves);
+        if (depth <= 1)
+            return depth == 1 ? moves.size() : 1;
+
+        uint64_t nodes = 0;
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            board.makeMove(moves[i]);
+            nodes += perft(board, depth - 1);
+            board.unmakeMove();
+        }
+        return nodes;
+    }
+
+    // Positions reached after two plies from every bench position, as FEN strings
+    void collectPositions(Board &board, int depth, vector<string> &fens)
+    {
+        fens.push_back(board.getFEN());
+        if (depth == 0)
+            return;
+        MoveBuffer moves;
+        board.generateLegalMoves(board.getSideToMove(), moves);
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            board.makeMove(moves[i]);
+            collectPositions(board, depth - 1, fens);
+            board.unmakeMove();
+        }
+    }
+
+    int runMovegen(const BenchOptions &options)
+    {
+        int depth = options.depth > 0 ? options.depth : 4;
+        cout << "Move generation, " << BENCH_POSITION_COUNT << " positions" << endl;
+
+        vector<Board> boards(BENCH_POSITION_COUNT);
+        uint64_t nodes = 0;
+        auto start = chrono::steady_clock::now();
+        for (size_t i = 0; i < boards.size(); ++i)
+        {
+            boards[i].loadFEN(BENCH_POSITIONS[i]);
+            nodes += perft(boards[i], depth);
+        }
+        double perftMs = millisecondsSince(start);
+        printf("Perft depth %d: %llu nodes, %.1f ms, %llu nodes/s\n", depth, (unsigned long long)nodes, perftMs,
+               (unsigned long long)(perftMs > 0 ? nodes * 1000.0 / perftMs : 0));
+
+        // Stage timings: each position is loaded once, then generated over and over
+        vector<string> fens;
+        for (size_t i = 0; i < boards.size(); ++i)
+            collectPositions(boards[i], 2, fens);
+        vector<Board> quiet, inCheck;
+        for (const string &fen : fens)
+        {
+            Board board;
+            board.loadFEN(fen);
+            Color us = board.getSideToMove();
+            bool checked = (board.attacks(opposite(us)) & board.pieces(us, KING)) != 0;
+            (checked ? inCheck : quiet).push_back(board);
+        }
+
+        cout << "Stage         Positions  Moves/position  Positions/s" << endl;
+        const struct
+        {
+            const char *name;
+            GenType type;
+            const vector<Board> *positions;
+        } stages[] = {{"captures", CAPTURES, &quiet}, {"quiets", QUIETS, &quiet},
+                      {"non-evasions", NON_EVASIONS, &quiet}, {"evasions", EVASIONS, &inCheck}};
+        for (const auto &stage : stages)
+        {
+            const int rounds = 20;
+            uint64_t generated = 0;
+            MoveBuffer moves;
+            start = chrono::steady_clock::now();
+            for (int round = 0; round < rounds; ++round)
+            {
+                for (const Board &board : *stage.positions)
+                {
+                    moves.clear();
+                    board.generateMoves(stage.type, moves);
+                    generated += moves.size();
+                }
+            }
+            double stageMs = millisecondsSince(start);
+            uint64_t calls = uint64_t(rounds) * stage.positions->size();
+            printf("%-13s %-10zu %-15.1f %llu\n", stage.name, stage.positions->size(),
+                   calls ? double(generated) / calls : 0.0,
+                   (unsigned long long)(stageMs > 0 ? calls * 1000.0 / stageMs : 0));
+        }
+        return 0;
+    }
+
+    // The same workloads under each backend the CPU can run
+    int runSliders(const BenchOptions &options)
+    {
+        int depth = options.depth > 0 ? options.depth : 4;
+        SliderBackend original = sliderBackend;
+        cout << "Sliding attacks, selected backend: " << sliderBackendName(original)
+             << (cpuHasFastPext() ? " (CPU has fast PEXT)" : " (no fast PEXT on this CPU)") << endl;
+
+        // Random blockers, about a quarter of the board full, like a middlegame
+        mt19937_64 random(2024);
+        vector<Bitboard> occupancies(4096);
+        for (Bitboard &occ : occupancies)
+            occ = random() & random();
+
+        vector<Board> boards(BENCH_POSITION_COUNT);
+        cout << "Backend  Lookups/s      Perft depth " << depth << " nodes/s" << endl;
+        for (SliderBackend backend : {MAGIC_BACKEND, PEXT_BACKEND})
+        {
+            if (!setSliderBackend(backend))
+            {
+                cout << sliderBackendName(backend) << "    (not supported)" << endl;
+                continue;
+            }
+
+            const int rounds = 200;
+            Bitboard sink = 0;
+            auto start = chrono::steady_clock::now();
+            for (int round = 0; round < rounds; ++round)
+            {
+                for (size_t i = 0; i < occupancies.size(); ++i)
+                {
+                    int sq = int(i & 63);
+                    sink ^= rookAttacks(sq, occupancies[i] ^ sink) ^ bishopAttacks(sq, occupancies[i]);
+                }
+            }
+            double lookupMs = millisecondsSince(start);
+            lookupSink = sink;
+            uint64_t lookups = uint64_t(rounds) * occupancies.size() * 2;
+
+            uint64_t nodes = 0;
+            start = chrono::steady_clock::now();
+            for (size_t i = 0; i < boards.size(); ++i)
+            {
+                boards[i].loadFEN(BENCH_POSITIONS[i]);
+                nodes += perft(boards[i], depth);
+            }
+            double perftMs = millisecondsSince(start);
+
+            printf("%-8s %-14llu %llu\n", sliderBackendName(backend),
+                   (unsigned long long)(lookupMs > 0 ? lookups * 1000.0 / lookupMs : 0),
+                   (unsigned long long)(perftMs > 0 ? nodes * 1000.0 / perftMs : 0));
+        }
+
+        setSliderBackend(original);
+        return 0;
+    }
+
+    int runSee(const BenchOptions &)
+    {
+        vector<string> fens;
+        for (size_t i = 0; i < BENCH_POSITION_COUNT; ++i)
+        {
+            Board board;
+            board.loadFEN(BENCH_POSITIONS[i]);
+            collectPositions(board, 2, fens);
+        }
+
+        // Every capture of every position, paired with its board
+        vector<Board> boards(fens.size());
+        vector<pair<int, Move>> captures;
+        for (size_t i = 0; i < fens.size(); ++i)
+        {
+            boards[i].loadFEN(fens[i]);
+            MoveBuffer moves;
+            boards[i].generateMoves(CAPTURES, moves);
+            for (int j = 0; j < moves.size(); ++j)
+                captures.push_back({int(i), moves[j]});
+        }
+        cout << "Static exchange evaluation, " << captures.size() << " captures in " << fens.size() << " positions" << endl;
+
+        const int rounds = 20;
+        int64_t total = 0;
+        int losing = 0;
+        auto start = chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (const auto &capture : captures)
+                total += see(boards[capture.first], capture.second);
+        }
+        double seeMs = millisecondsSince(start);
+
+        start = chrono::steady_clock::now();
+        for (int round = 0; round < rounds; ++round)
+        {
+            for (const auto &capture : captures)
+                losing += seeLoses(boards[capture.first], capture.second);
+        }
+        double signMs = millisecondsSince(start);
+        lookupSink = Bitboard(total);
+
+        uint64_t calls = uint64_t(rounds) * captures.size();
+        printf("see()       %llu calls/s, %.1f ns/call\n", (unsigned long long)(seeMs > 0 ? calls * 1000.0 / seeMs : 0),
+               calls ? seeMs * 1e6 / calls : 0.0);
+        printf("seeLoses()  %llu calls/s, %.1f ns/call, %.1f%% of captures lose material\n",
+               (unsigned long long)(signMs > 0 ? calls * 1000.0 / signMs : 0), calls ? signMs * 1e6 / calls : 0.0,
+               calls ? losing * 100.0 / calls : 0.0);
+        return 0;
+    }
+
+    // One random game from a bench position, seeded by its number. Along the way it
+    // takes moves back and replays them, copies the board, and checks the incremental
+    // state against a recomputation. Returns the final hash key, or 0 if a check failed.
+    uint64_t playRandomGame(int game)
+    {
+        mt19937_64 random(game);
+        Board board;
+        board.loadFEN(BENCH_POSITIONS[game % BENCH_POSITION_COUNT]);
+        MoveBuffer moves;
+        for (int ply = 0; ply < 120 && board.status() == ONGOING; ++ply)
+        {
+            moves.clear();
+            board.generateLegalMoves(board.getSideToMove(), moves);
+            Move move = moves[int(random() % moves.size())];
+            board.makeMove(move);
+            if (ply % 8 == 7)
+            {
+                board.unmakeMove();
+                board.makeMove(move);
+            }
+            if (ply == 60)
+            {
+                Board copy = board;
+                board = copy;
+            }
+            if (board.getHashKey() != board.computeHashKey() ||
+                board.attacks(WHITE) != board.computeAttacks(WHITE) ||
+                board.attacks(BLACK) != board.computeAttacks(BLACK))
+                return 0;
+        }
+        return board.getHashKey();
+    }
+
+    int runBoards(const BenchOptions &options)
+    {
+        cout << "Boards stress test, " << options.games << " games, " << options.threads << " threads" << endl;
+
+        // Played one after another first: the reference results
+        vector<uint64_t> expected(options.games);
+        auto start = chrono::steady_clock::now();
+        for (int game = 0; game < options.games; ++game)
+            expected[game] = playRandomGame(game);
+        double serialMs = millisecondsSince(start);
+
+        // Then all threads take games from a shared counter, many boards alive at once
+        vector<uint64_t> results(options.games);
+        atomic<int> nextGame(0);
+        vector<thread> threads;
+        start = chrono::steady_clock::now();
+        for (int i = 0; i < options.threads; ++i)
+        {
+            threads.emplace_back([&]() {
+                for (int game = nextGame++; game < options.games; game = nextGame++)
+                    results[game] = playRandomGame(game);
+            });
+        }
+        for (thread &t : threads)
+            t.join();
+        double parallelMs = millisecondsSince(start);
+
+        int failed = 0, mismatched = 0;
+        for (int game = 0; game < options.games; ++game)
+        {
+            if (expected[game] == 0)
+                ++failed;
+            else if (results[game] != expected[game])
+                ++mismatched;
+        }
+        printf("Serial %.1f ms, parallel %.1f ms (%.2fx)\n", serialMs, parallelMs,
+               parallelMs > 0 ? serialMs / parallelMs : 0);
+        printf("%d games failed a consistency check, %d ended differently in parallel\n", failed, mismatched);
+        return failed || mismatched ? 1 : 0;
+    }
+
+    // Time to depth is what matters for Lazy SMP: helpers add nodes that are partly
+    // duplicated work, so nodes per second alone overstates the gain.
+    int runSmp(const BenchOptions &options)
+    {
+        int depth = options.depth > 0 ? options.depth : 8;
+        cout << "Lazy SMP, depth " << depth << ", " << options.hashMb << " MB hash, "
+             << BENCH_POSITION_COUNT << " positions" << (options.nullMove ? "" : ", no null move")
+             << (options.lateMoveReductions ? "" : ", no late move reductions") << endl;
+        cout << "Threads  Nodes          QNodes         FH first %  Time to depth (ms)  Nodes/s       Speedup" << endl;
+
+        // Boards are created up front, on this thread
+        vector<Board> boards(BENCH_POSITION_COUNT);
+        TranspositionTable tt(options.hashMb);
+
+        SearchLimits limits(depth, 0);
+        limits.nullMove = options.nullMove;
+        limits.lateMoveReductions = options.lateMoveReductions;
+
+        double baseMs = 0;
+        for (int threads = 1;; threads = min(threads * 2, options.threads))
+        {
+            // A fresh search for each thread count, so none inherits the move ordering
+            // history of the runs before it
+            ParallelSearch search(tt);
+            search.setThreadCount(threads);
+            uint64_t nodes = 0, qnodes = 0, failHighs = 0, failHighsFirst = 0;
+            double elapsedMs = 0;
+            for (size_t i = 0; i < boards.size(); ++i)
+            {
+                boards[i].loadFEN(BENCH_POSITIONS[i]);
+                tt.clear(); // Every position starts cold, as in a fresh game
+                SearchResult result = search.run(boards[i], limits);
+                nodes += result.nodes;
+                qnodes += result.qnodes;
+                failHighs += result.failHighs;
+                failHighsFirst += result.failHighsFirst;
+                elapsedMs += result.elapsedMs;
+            }
+            if (threads == 1)
+                baseMs = elapsedMs;
+
+            printf("%-8d %-14llu %-14llu %-11.1f %-19.1f %-13llu %.2f\n", threads, (unsigned long long)nodes,
+                   (unsigned long long)qnodes, failHighs > 0 ? failHighsFirst * 100.0 / failHighs : 0, elapsedMs,
+                   (unsigned long long)(elapsedMs > 0 ? nodes * 1000.0 / elapsedMs : 0),
+                   elapsedMs > 0 ? baseMs / elapsedMs : 0);
+            if (threads >= options.threads)
+                break;
+        }
+        return 0;
+    }
+
+    // Selectivity trades accuracy for depth: each technique should cut the tree a lot
+    // while rarely changing the move or the score of the full-width search
+    int runPruning(const BenchOptions &options)
+    {
+        int depth = options.depth > 0 ? options.depth : 8;
+        cout << "Pruning, depth " << depth << ", " << options.hashMb << " MB hash, "
+             << BENCH_POSITION_COUNT << " positions, 1 thread" << endl;
+        cout << "Search           Nodes          Time to depth (ms)  Speedup  Other move  Mean score diff" << endl;
+
+        struct Variant
+        {
+            const char *name;
+            bool nullMove;
+            bool lateMoveReductions;
+        };
+        const Variant variants[] = {
+            {"full width", false, false},
+            {"null move", true, false},
+            {"LMR", false, true},
+            {"null move + LMR", true, true},
+        };
+
+        Board board;
+        TranspositionTable tt(options.hashMb);
+        SearchResult reference[BENCH_POSITION_COUNT];
+        double baseMs = 0;
+        for (const Variant &variant : variants)
+        {
+            // A fresh search each time, so no variant inherits another one's history
+            ParallelSearch search(tt);
+            SearchLimits limits(depth, 0);
+            limits.nullMove = variant.nullMove;
+            limits.lateMoveReductions = variant.lateMoveReductions;
+
+            uint64_t nodes = 0;
+            double elapsedMs = 0;
+            int otherMoves = 0, scoreDiff = 0;
+            for (size_t i = 0; i < BENCH_POSITION_COUNT; ++i)
+            {
+                board.loadFEN(BENCH_POSITIONS[i]);
+                tt.clear();
+                SearchResult result = search.run(board, limits);
+                nodes += result.nodes;
+                elapsedMs += result.elapsedMs;
+                if (&variant == variants)
+                    reference[i] = result;
+                if (result.bestMove != reference[i].bestMove)
+                    ++otherMoves;
+                scoreDiff += abs(result.score - reference[i].score);
+            }
+            if (&variant == variants)
+                baseMs = elapsedMs;
+
+            printf("%-16s %-14llu %-19.1f %-8.2f %-11d %.1f\n", variant.name, (unsigned long long)nodes, elapsedMs,
+                   elapsedMs > 0 ? baseMs / elapsedMs : 0, otherMoves, double(scoreDiff) / BENCH_POSITION_COUNT);
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    BenchOptions options;
+    vector<string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "--depth" && i + 1 < argc)
+            options.depth = max(1, atoi(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc)
+            options.threads = max(1, atoi(argv[++i]));
+        else if (arg == "--hash" && i + 1 < argc)
+            options.hashMb = max(1, atoi(argv[++i]));
+        else if (arg == "--games" && i + 1 < argc)
+            options.games = max(1, atoi(argv[++i]));
+        else if (arg == "--no-null")
+            options.nullMove = false;
+        else if (arg == "--no-lmr")
+            options.lateMoveReductions = false;
+        else
+            args.push_back(arg);
+    }
+
+    string section = args.empty() ? "smp" : args[0];
+    if (section == "smp")
+        return runSmp(options);
+    if (section == "movegen")
+        return runMovegen(options);
+    if (section == "sliders")
+        return runSliders(options);
+    if (section == "see")
+        return runSee(options);
+    if (section == "boards")
+        return runBoards(options);
+    if (section == "pruning")
+        return runPruning(options);
+
+    cerr << "Usage: bench smp [--depth D] [--threads MAX] [--hash MB] [--no-null] [--no-lmr]" << endl;
+    cerr << "       bench movegen [--depth D]" << endl;
+    cerr << "       bench sliders [--depth D]" << endl;
+    cerr << "       bench see" << endl;
+    cerr << "       bench boards [--games N] [--threads MAX]" << endl;
+    cerr << "       bench pruning [--depth D] [--hash MB]" << endl;
+    return 1;
+}
@@ -0,0 +1,95 @@
+// Magicgen: finds the magic multipliers embedded in Magic.cpp.
+//
+// A magic maps every blocker arrangement on a slider's relevance mask to a distinct
+// table slot (or to a slot holding the same attacks), via ((occupied & mask) * magic) >> shift.
+// Magics depend on the square numbering, so they have to be regenerated if that ever
+// changes. The search is seeded, so the output is the same on every run.
+//
+// Usage:
+//   magicgen > magics.txt    then paste the two arrays into Magic.cpp
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include "Bitboard.h"
+#include "SliderGen.h"
+
+using namespace std;
+using namespace SliderGen;
+
+namespace
+{
+    uint64_t randomState = 0x9E3779B97F4A7C15ULL;
+
+    uint64_t nextRandom()
+    {
+        // xorshift64*
+        randomState ^= randomState >> 12;
+        randomState ^= randomState << 25;
+        randomState ^= randomState >> 27;
+        return randomState * 0x2545F4914F6CDD1DULL;
+    }
+
+    // Few set bits make better magics
+    uint64_t sparseRandom() { return nextRandom() & nextRandom() & nextRandom(); }
+
+    uint64_t findMagic(int sq, const int *dx, const int *dy)
+    {
+        Bitboard mask = relevanceMask(sq, dx, dy);
+        int bits = popCount(mask);
+        int size = 1 << bits;
+
+        // Every subset of the mask, with its attacks (carry-rippler enumeration)
+        vector<Bitboard> occupancies, attacks;
+        Bitboard subset = 0;
+        do
+        {
+            occupancies.push_back(subset);
+            attacks.push_back(slidingAttacks(sq, subset, dx, dy));
+            subset = (subset - mask) & mask;
+        } while (subset);
+
+        vector<Bitboard> table(size);
+        vector<int> usedBy(size);
+        for (int attempt = 1;; ++attempt)
+        {
+            uint64_t magic = sparseRandom();
+            if (popCount((mask * magic) & 0xFF00000000000000ULL) < 6)
+                continue;
+
+            bool ok = true;
+            for (int i = 0; i < size && ok; ++i)
+            {
+                int index = int((occupancies[i] * magic) >> (64 - bits));
+                if (usedBy[index] != attempt)
+                {
+                    usedBy[index] = attempt;
+                    table[index] = attacks[i];
+                }
+                else if (table[index] != attacks[i])
+                {
+                    ok = false;
+                }
+            }
+            if (ok)
+                return magic;
+        }
+    }
+
+    void printMagics(const char *name, const int *dx, const int *dy)
+    {
+        printf("constexpr Bitboard %s[64] = {\n", name);
+        for (int sq = 0; sq < 64; ++sq)
+            printf("%s0x%016llXULL,%s", sq % 4 == 0 ? "    " : " ", (unsigned long long)findMagic(sq, dx, dy),
+                   sq % 4 == 3 ? "\n" : "");
+        printf("};\n");
+    }
+}
+
+int main()
+{
+    printMagics("ROOK_MAGICS", ROOK_DX, ROOK_DY);
+    printf("\n");
+    printMagics("BISHOP_MAGICS", BISHOP_DX, BISHOP_DY);
+    return 0;
+}
@@ -0,0 +1,470 @@
+// Perft: counts the leaf nodes of the legal move tree to a fixed depth, to check
+// the move generator against known counts and to measure its speed.
+//
+// Usage:
+//   perft <depth> [fen]        Divide: node count under each root move, then the total
+//   perft --suite [depth]      Reference positions against their published counts
+//                              (each position to its default depth, or at most `depth`)
+//   perft --scaling <depth> [fen]
+//                              Same count with 1, 2, 4, ... threads, with speedup and efficiency
+// Options (any mode):
+//   --threads N                Worker threads (default 1)
+//   --hash MB                  Share a cache of subtree counts between threads (default off)
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Board.h"
+
+using namespace std;
+
+namespace
+{
+    const string START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+    // Published counts from the Chess Programming Wiki "Perft Results" page
+    struct ReferencePosition
+    {
+        const char *name;
+        const char *fen;
+        int defaultDepth;          // Deepest depth run by a plain --suite (a few seconds each)
+        uint64_t expected[7];      // expected[d - 1] = nodes at depth d, 0 when not listed
+    };
+
+    const ReferencePosition REFERENCE_POSITIONS[] = {
+        {"Start position", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5,
+         {20, 400, 8902, 197281, 4865609, 119060324, 3195901860ULL}},
+        {"Kiwipete", "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4,
+         {48, 2039, 97862, 4085603, 193690690, 8031647685ULL, 0}},
+        {"Position 3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6,
+         {14, 191, 2812, 43238, 674624, 11030083, 178633661}},
+        {"Position 4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5,
+         {6, 264, 9467, 422333, 15833292, 706045033, 0}},
+        {"Position 5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4,
+         {44, 1486, 62379, 2103487, 89941194, 0, 0}},
+        {"Position 6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4,
+         {46, 2079, 89890, 3894594, 164075551, 6923051137ULL, 0}},
+    };
+
+    string moveToString(const Move &move)
+    {
+        static const char PROMOTION_LETTERS[6] = {'p', 'n', 'b', 'r', 'q', 'k'};
+        string text;
+        text += char('a' + move.startY());
+        text += char('8' - move.startX());
+        text += char('a' + move.endY());
+        text += char('8' - move.endX());
+        if (move.isPromotion())
+            text += PROMOTION_LETTERS[move.promotionType()];
+        return text;
+    }
+
+    // Subtree counts keyed by position hash and remaining depth, shared by all threads.
+    // Same lock-free scheme as the transposition table: a slot holds the count and
+    // key ^ count, so a slot torn by two writers fails the check and reads as a miss.
+    class PerftCache
+    {
+    public:
+        explicit PerftCache(size_t megabytes)
+        {
+            size_t wanted = megabytes * 1024 * 1024 / sizeof(Slot);
+            slotCount = 1;
+            while (slotCount * 2 <= wanted)
+                slotCount *= 2;
+            slots.reset(new Slot[slotCount]);
+            clear();
+        }
+
+        void clear()
+        {
+            for (size_t i = 0; i < slotCount; ++i)
+            {
+                slots[i].keyXorNodes.store(0, memory_order_relaxed);
+                slots[i].nodes.store(0, memory_order_relaxed);
+            }
+        }
+
+        bool probe(uint64_t hash, int depth, uint64_t &nodes) const
+        {
+            uint64_t key = keyFor(hash, depth);
+            const Slot &slot = slots[key & (slotCount - 1)];
+            uint64_t stored = slot.nodes.load(memory_order_relaxed);
+            if ((slot.keyXorNodes.load(memory_order_relaxed) ^ stored) != key || stored == 0)
+                return false;
+            nodes = stored;
+            return true;
+        }
+
+        // Always replaces: perft revisits the same subtrees soon after storing them
+        void store(uint64_t hash, int depth, uint64_t nodes)
+        {
+            uint64_t key = keyFor(hash, depth);
+            Slot &slot = slots[key & (slotCount - 1)];
+            slot.nodes.store(nodes, memory_order_relaxed);
+            slot.keyXorNodes.store(key ^ nodes, memory_order_relaxed);
+        }
+
+    private:
+        struct Slot
+        {
+            atomic<uint64_t> keyXorNodes;
+            atomic<uint64_t> nodes;
+        };
+
+        // The same position at another depth has another count
+        static uint64_t keyFor(uint64_t hash, int depth) { return hash ^ (uint64_t(depth) * 0x9E3779B97F4A7C15ULL); }
+
+        unique_ptr<Slot[]> slots;
+        size_t slotCount;
+    };
+
+    // Leaf nodes at `depth`. The last ply is counted from the legal move list
+    // instead of being played out.
+    uint64_t perft(Board &board, int depth, PerftCache *cache)
+    {
+        MoveBuffer moves;
+        board.generateLegalMoves(board.getSideToMove(), moves);
+        if (depth <= 1)
+            return depth == 1 ? moves.size() : 1;
+
+        uint64_t nodes = 0;
+        if (cache && cache->probe(board.getHashKey(), depth, nodes))
+            return nodes;
+
+        for (int i = 0; i < moves.size(); ++i)
+        {
+            board.makeMove(moves[i]);
+            nodes += perft(board, depth - 1, cache);
+            board.unmakeMove();
+        }
+
+        if (cache)
+            cache->store(board.getHashKey(), depth, nodes);
+        return nodes;
+    }
+
+    // Fixed set of tasks spread over per-thread queues. A thread takes work from the
+    // front of its own queue and, once that is empty, steals from the back of the others,
+    // so threads that drew small subtrees help out the ones that drew big ones.
+    class WorkStealingPool
+    {
+    public:
+        explicit WorkStealingPool(int threadCount) : queues(threadCount), steals(0) {}
+
+        // Runs work(thread, task) for every task in [0, taskCount) and waits for all of them
+        void run(int taskCount, const function<void(int, int)> &work)
+        {
+            int threadCount = int(queues.size());
+            for (int task = 0; task < taskCount; ++task)
+                queues[task % threadCount].tasks.push_back(task);
+
+            vector<thread> threads;
+            for (int id = 1; id < threadCount; ++id)
+                threads.emplace_back([this, id, &work]() { workerLoop(id, work); });
+            workerLoop(0, work); // The calling thread is worker 0
+            for (thread &t : threads)
+                t.join();
+        }
+
+        uint64_t getSteals() const { return steals.load(); }
+
+    private:
+        struct TaskQueue
+        {
+            mutex lock;
+            deque<int> tasks;
+        };
+
+        void workerLoop(int id, const function<void(int, int)> &work)
+        {
+            int task;
+            while (takeTask(id, task))
+                work(id, task);
+        }
+
+        bool takeTask(int id, int &task)
+        {
+            {
+                lock_guard<mutex> guard(queues[id].lock);
+                if (!queues[id].tasks.empty())
+                {
+                    task = queues[id].tasks.front();
+                    queues[id].tasks.pop_front();
+                    return true;
+                }
+            }
+
+            // No task is ever added after the start, so one empty sweep means all work is taken
+            for (size_t offset = 1; offset < queues.size(); ++offset)
+            {
+                TaskQueue &victim = queues[(id + offset) % queues.size()];
+                lock_guard<mutex> guard(victim.lock);
+                if (!victim.tasks.empty())
+                {
+                    task = victim.tasks.back();
+                    victim.tasks.pop_back();
+                    steals.fetch_add(1);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        vector<TaskQueue> queues;
+        atomic<uint64_t> steals;
+    };
+
+    struct PerftOptions
+    {
+        int threads;
+        size_t hashMb; // 0 = no cache
+
+        PerftOptions() : threads(1), hashMb(0) {}
+    };
+
+    // Node count under each legal root move of `fen`, in the order of rootMoves.
+    // With more than one thread the tree is split after two plies: every (root move, reply)
+    // pair is one task, which gives enough tasks to keep all threads busy.
+    uint64_t parallelDivide(const string &fen, int depth, int threadCount, PerftCache *cache, MoveBuffer &rootMoves,
+                            vector<uint64_t> &rootCounts, uint64_t *steals = nullptr)
+    {
+        // One board per thread, each with its own position and history. They are all
+        // loaded here so that the first one can list the root moves the tasks are made of.
+        unique_ptr<Board[]> boards(new Board[threadCount]);
+        for (int i = 0; i < threadCount; ++i)
+            boards[i].loadFEN(fen);
+
+        Board &root = boards[0];
+        rootMoves.clear();
+        root.generateLegalMoves(root.getSideToMove(), rootMoves);
+        rootCounts.assign(rootMoves.size(), 0);
+
+        if (threadCount == 1 || depth < 3)
+        {
+            for (int i = 0; i < rootMoves.size(); ++i)
+            {
+                root.makeMove(rootMoves[i]);
+                rootCounts[i] = perft(root, depth - 1, cache);
+                root.unmakeMove();
+            }
+        }
+        else
+        {
+            struct Task
+            {
+                int rootIndex;
+                Move reply;
+            };
+            vector<Task> tasks;
+            for (int i = 0; i < rootMoves.size(); ++i)
+            {
+                root.makeMove(rootMoves[i]);
+                MoveBuffer replies;
+                root.generateLegalMoves(root.getSideToMove(), replies);
+                for (int j = 0; j < replies.size(); ++j)
+                    tasks.push_back({i, replies[j]});
+                root.unmakeMove();
+            }
+
+            vector<uint64_t> taskCounts(tasks.size(), 0);
+            WorkStealingPool pool(threadCount);
+            pool.run(int(tasks.size()), [&](int worker, int index)
+            {
+                Board &board = boards[worker];
+                board.makeMove(rootMoves[tasks[index].rootIndex]);
+                board.makeMove(tasks[index].reply);
+                taskCounts[index] = perft(board, depth - 2, cache);
+                board.unmakeMove();
+                board.unmakeMove();
+            });
+
+            for (size_t i = 0; i < tasks.size(); ++i)
+                rootCounts[tasks[i].rootIndex] += taskCounts[i];
+            if (steals)
+                *steals = pool.getSteals();
+        }
+
+        uint64_t total = 0;
+        for (uint64_t nodes : rootCounts)
+            total += nodes;
+        return total;
+    }
+
+    uint64_t countNodes(const string &fen, int depth, int threadCount, PerftCache *cache, uint64_t *steals = nullptr)
+    {
+        MoveBuffer rootMoves;
+        vector<uint64_t> rootCounts;
+        return parallelDivide(fen, depth, threadCount, cache, rootMoves, rootCounts, steals);
+    }
+
+    unique_ptr<PerftCache> makeCache(const PerftOptions &options)
+    {
+        return unique_ptr<PerftCache>(options.hashMb > 0 ? new PerftCache(options.hashMb) : nullptr);
+    }
+
+    double secondsSince(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+
+    void printSpeed(uint64_t nodes, double seconds)
+    {
+        cout << "Nodes: " << nodes << endl;
+        cout << "Time: " << seconds * 1000 << " ms" << endl;
+        cout << "Speed: " << (uint64_t)(seconds > 0 ? nodes / seconds : 0) << " nodes/s" << endl;
+    }
+
+    bool isValidFEN(const string &fen)
+    {
+        Board board;
+        if (board.loadFEN(fen))
+            return true;
+        cerr << "Invalid FEN: " << fen << endl;
+        return false;
+    }
+
+    int runDivide(const string &fen, int depth, const PerftOptions &options)
+    {
+        if (!isValidFEN(fen))
+            return 1;
+
+        unique_ptr<PerftCache> cache = makeCache(options);
+        auto start = chrono::steady_clock::now();
+        MoveBuffer moves;
+        vector<uint64_t> counts;
+        uint64_t total = parallelDivide(fen, depth, options.threads, cache.get(), moves, counts);
+        double seconds = secondsSince(start);
+
+        for (int i = 0; i < moves.size(); ++i)
+            cout << moveToString(moves[i]) << ": " << counts[i] << endl;
+        cout << endl;
+        printSpeed(total, seconds);
+        return 0;
+    }
+
+    // Times the same count with 1, 2, 4, ... threads up to maxThreads. Efficiency is
+    // speedup / threads: 100% means every added thread did a full thread's worth of work.
+    int runScaling(const string &fen, int depth, int maxThreads, const PerftOptions &options)
+    {
+        if (!isValidFEN(fen))
+            return 1;
+
+        unique_ptr<PerftCache> cache = makeCache(options);
+        cout << "Threads  Nodes          Time (ms)  Nodes/s       Speedup  Efficiency  Steals" << endl;
+        double baseSeconds = 0;
+        uint64_t baseNodes = 0;
+        for (int threads = 1;; threads = min(threads * 2, maxThreads))
+        {
+            if (cache)
+                cache->clear(); // No run may profit from the counts of an earlier one
+
+            uint64_t steals = 0;
+            auto start = chrono::steady_clock::now();
+            uint64_t nodes = countNodes(fen, depth, threads, cache.get(), &steals);
+            double seconds = secondsSince(start);
+            if (threads == 1)
+            {
+                baseSeconds = seconds;
+                baseNodes = nodes;
+            }
+
+            double speedup = seconds > 0 ? baseSeconds / seconds : 0;
+            printf("%-8d %-14llu %-10.1f %-13llu %-8.2f %9.1f%%  %llu%s\n", threads, (unsigned long long)nodes,
+                   seconds * 1000, (unsigned long long)(seconds > 0 ? nodes / seconds : 0), speedup,
+                   speedup * 100 / threads, (unsigned long long)steals, nodes == baseNodes ? "" : "  COUNT MISMATCH");
+            if (nodes != baseNodes)
+                return 1;
+            if (threads >= maxThreads)
+                break;
+        }
+        return 0;
+    }
+
+    int runSuite(int maxDepth, const PerftOptions &options)
+    {
+        // One cache for the whole suite: it is keyed by depth, so counts stay exact
+        unique_ptr<PerftCache> cache = makeCache(options);
+        int failures = 0;
+        uint64_t totalNodes = 0;
+        auto suiteStart = chrono::steady_clock::now();
+        for (const ReferencePosition &position : REFERENCE_POSITIONS)
+        {
+            int depth = maxDepth > 0 ? maxDepth : position.defaultDepth;
+            cout << position.name << " (" << position.fen << ")" << endl;
+
+            for (int d = 1; d <= depth && d <= 7 && position.expected[d - 1]; ++d)
+            {
+                auto start = chrono::steady_clock::now();
+                uint64_t nodes = countNodes(position.fen, d, options.threads, cache.get());
+                double seconds = secondsSince(start);
+                totalNodes += nodes;
+
+                bool ok = nodes == position.expected[d - 1];
+                failures += !ok;
+                cout << "  depth " << d << ": " << nodes << (ok ? " ok" : " FAILED, expected ")
+                     << (ok ? "" : to_string(position.expected[d - 1])) << " (" << seconds * 1000 << " ms, "
+                     << (uint64_t)(seconds > 0 ? nodes / seconds : 0) << " nodes/s)" << endl;
+            }
+        }
+
+        cout << endl;
+        printSpeed(totalNodes, secondsSince(suiteStart));
+        cout << (failures ? to_string(failures) + " count(s) wrong" : string("All counts match")) << endl;
+        return failures ? 1 : 0;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // Options first, everything else is the mode and its arguments
+    PerftOptions options;
+    bool threadsGiven = false;
+    vector<string> args;
+    for (int i = 1; i < argc; ++i)
+    {
+        string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc)
+        {
+            options.threads = max(1, atoi(argv[++i]));
+            threadsGiven = true;
+        }
+        else if (arg == "--hash" && i + 1 < argc)
+            options.hashMb = max(0, atoi(argv[++i]));
+        else
+            args.push_back(arg);
+    }
+
+    string mode = args.empty() ? "" : args[0];
+    bool hasDepth = args.size() >= 2 && atoi(args[1].c_str()) >= 1;
+    // The FEN may be passed as one quoted argument or as separate fields
+    size_t fenStart = mode == "--scaling" ? 2 : 1;
+    string fen;
+    for (size_t i = fenStart; i < args.size(); ++i)
+        fen += (i > fenStart ? " " : "") + args[i];
+    if (fen.empty())
+        fen = START_FEN;
+
+    if (mode == "--suite")
+        return runSuite(args.size() >= 2 ? atoi(args[1].c_str()) : 0, options);
+    if (mode == "--scaling" && hasDepth)
+    {
+        int maxThreads = threadsGiven ? options.threads : max(1, int(thread::hardware_concurrency()));
+        return runScaling(fen, atoi(args[1].c_str()), maxThreads, options);
+    }
+    if (!mode.empty() && atoi(mode.c_str()) >= 1)
+        return runDivide(fen, atoi(mode.c_str()), options);
+
+    cerr << "Usage: perft <depth> [fen] [--threads N] [--hash MB]" << endl;
+    cerr << "       perft --suite [depth] [--threads N] [--hash MB]" << endl;
+    cerr << "       perft --scaling <depth> [fen] [--threads MAX] [--hash MB]" << endl;
+    return 1;
+}